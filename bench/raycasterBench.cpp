@@ -0,0 +1,879 @@
+// Headless benchmark for the raycaster and the maze generators.
+//
+// Builds mazes from a fixed seed, walks a scripted camera path through
+// Raycaster::castAllRays at a range of screen widths and view distances,
+// times batches of agent views through Raycaster::castViews and of
+// line of sight segments, moves batches of colliding entities, finds
+// paths and steers agents with flow fields, edits the map under cached
+// rays and fields, draws sprites over the walls, and prints the results
+// as JSON on stdout so runs can be compared across releases. Needs no
+// display and does not link SDL.
+//
+// Usage: raycaster_bench [--frames N] [--threads N] [--lanes N] [--seed N] [--quick]
+
+#include "raycaster.h"
+#include "depthFirstMazeGenerator.h"
+#include "recursiveDivisionMazeGenerator.h"
+#include "bitPackedDepthFirstMazeGenerator.h"
+#include "tiledMazeGenerator.h"
+#include "mazeFile.h"
+#include "wallTextures.h"
+#include "floorCaster.h"
+#include "movementSystem.h"
+#include "gridPathfinder.h"
+#include "flowField.h"
+#include "spriteRenderer.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+struct BenchConfig {
+    int frames = 120;
+    int threads = 1;
+    int lanes = 0;          // 0 = widest the CPU supports
+    unsigned int seed = 12345;
+    bool quick = false;
+};
+
+struct CameraPose {
+    float x;
+    float y;
+    float angle;
+};
+
+static double secondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Scripted path: evenly spaced open cells visited in row-major order, turning a little each frame
+static std::vector<CameraPose> buildCameraPath(const WorldMap& worldMap, int frames) {
+    std::vector<CameraPose> openCells;
+    for (int y = 0; y < worldMap.getHeight(); y++) {
+        for (int x = 0; x < worldMap.getWidth(); x++) {
+            if (!worldMap.isWall(x, y)) {
+                openCells.push_back({ x + 0.5f, y + 0.5f, 0.0f });
+            }
+        }
+    }
+
+    std::vector<CameraPose> path;
+    for (int frame = 0; frame < frames && !openCells.empty(); frame++) {
+        CameraPose pose = openCells[(static_cast<size_t>(frame) * openCells.size()) / frames];
+        pose.angle = frame * 0.37f;
+        path.push_back(pose);
+    }
+    return path;
+}
+
+template<typename Generator>
+static std::vector<std::vector<int>> generateTimed(const char* name, int size, unsigned int seed, bool& first) {
+    auto start = std::chrono::steady_clock::now();
+    Generator generator(size, size, seed);
+    generator.generateMaze();
+    double seconds = secondsSince(start);
+
+    double cells = static_cast<double>(generator.getWidth()) * generator.getHeight();
+    std::printf("%s    {\"generator\": \"%s\", \"width\": %d, \"height\": %d, \"seconds\": %.6f, \"cells_per_sec\": %.1f}",
+                first ? "" : ",\n", name, generator.getWidth(), generator.getHeight(), seconds, cells / seconds);
+    first = false;
+    return generator.getMaze();
+}
+
+// The bit-packed generator is only timed, its mazes are too big to cast into
+static void generatePackedTimed(int size, unsigned int seed, bool& first) {
+    auto start = std::chrono::steady_clock::now();
+    BitPackedDepthFirstMazeGenerator generator(size, size, seed);
+    generator.generateMaze();
+    double seconds = secondsSince(start);
+
+    double cells = static_cast<double>(generator.getWidth()) * generator.getHeight();
+    std::printf("%s    {\"generator\": \"depth_first_bit_packed\", \"width\": %d, \"height\": %d, \"seconds\": %.6f, \"cells_per_sec\": %.1f}",
+                first ? "" : ",\n", generator.getWidth(), generator.getHeight(), seconds, cells / seconds);
+    first = false;
+}
+
+static void generateTiledTimed(const char* name, TiledMazeAlgorithm algorithm, int size, unsigned int seed,
+                               ThreadPool* pool, bool& first) {
+    auto start = std::chrono::steady_clock::now();
+    TiledMazeGenerator generator(size, size, seed, algorithm);
+    generator.setThreadPool(pool);
+    generator.generateMaze();
+    double seconds = secondsSince(start);
+
+    double cells = static_cast<double>(generator.getWidth()) * generator.getHeight();
+    std::printf("%s    {\"generator\": \"%s\", \"width\": %d, \"height\": %d, \"threads\": %d, \"seconds\": %.6f, \"cells_per_sec\": %.1f}",
+                first ? "" : ",\n", name, generator.getWidth(), generator.getHeight(), pool->getThreadCount(),
+                seconds, cells / seconds);
+    first = false;
+}
+
+/**
+ * @brief Round trip a maze through a binary maze file
+ *
+ * Times writing, loading with and without a checksum pass, and checks the
+ * loaded grid matches the in-memory one cell for cell. Uses a scratch file
+ * in the working directory that is removed afterwards.
+ */
+static void benchMazeFile(const char* name, const std::vector<std::vector<int>>& maze, MazeFileEncoding encoding,
+                          bool& first) {
+    const char* path = "raycaster_bench_maze.tmp";
+    MapGrid reference(maze, maze.size(), maze[0].size());
+
+    auto start = std::chrono::steady_clock::now();
+    bool written = writeMazeFile(path, maze, MazeFileGenerator::DEPTH_FIRST, 0, encoding);
+    double writeSeconds = secondsSince(start);
+
+    start = std::chrono::steady_clock::now();
+    MapGrid loaded;
+    bool ok = written && loadMazeFile(path, loaded);
+    double loadSeconds = secondsSince(start);
+
+    start = std::chrono::steady_clock::now();
+    MapGrid verified;
+    ok = ok && loadMazeFile(path, verified, nullptr, true);
+    double verifiedSeconds = secondsSince(start);
+
+    bool matches = ok && loaded.getWidth() == reference.getWidth() && loaded.getHeight() == reference.getHeight();
+    for (int y = 0; matches && y < reference.getHeight(); y++) {
+        for (int x = 0; x < reference.getWidth(); x++) {
+            // BITS keeps walls but not their types
+            bool same = encoding == MazeFileEncoding::BITS ? (loaded.at(x, y) != 0) == (reference.at(x, y) != 0)
+                                                           : loaded.at(x, y) == reference.at(x, y);
+            if (!same) {
+                matches = false;
+                break;
+            }
+        }
+    }
+    std::remove(path);
+
+    std::printf("%s    {\"encoding\": \"%s\", \"width\": %d, \"height\": %d, \"write_seconds\": %.6f, "
+                "\"load_seconds\": %.6f, \"load_verified_seconds\": %.6f, \"matches\": %s}",
+                first ? "" : ",\n", name, reference.getWidth(), reference.getHeight(), writeSeconds, loadSeconds,
+                verifiedSeconds, matches ? "true" : "false");
+    first = false;
+}
+
+// Open room with sparse single cell pillars, where distance field skipping pays off
+static std::vector<std::vector<int>> buildOpenArena(int size, unsigned int seed) {
+    RandomNumberGenerator rng(seed);
+    std::vector<std::vector<int>> arena(size, std::vector<int>(size, 0));
+    for (int y = 0; y < size; y++) {
+        for (int x = 0; x < size; x++) {
+            bool edge = x == 0 || y == 0 || x == size - 1 || y == size - 1;
+            arena[y][x] = (edge || rng.randomInt(0, 499) == 0) ? 1 : 0;
+        }
+    }
+    return arena;
+}
+
+static void benchCasting(const char* mapName, const WorldMap& worldMap, const BenchConfig& config,
+                         ThreadPool* pool, const std::vector<int>& widths,
+                         const std::vector<float>& distances, bool& first,
+                         const DistanceField* distanceField = nullptr) {
+    std::vector<CameraPose> path = buildCameraPath(worldMap, config.frames);
+    std::vector<RayHit> rayResults;
+
+    Raycaster raycaster(worldMap);
+    raycaster.setThreadPool(pool);
+    raycaster.setDistanceField(distanceField);
+    if (config.lanes > 0) {
+        raycaster.setPacketLanes(config.lanes);
+    }
+
+    for (float maxDistance : distances) {
+        raycaster.setMaxDistance(maxDistance);
+
+        for (int width : widths) {
+            // One untimed pass sizes the buffers and warms the caches
+            Player warmup(path[0].x, path[0].y, path[0].angle, 90);
+            raycaster.castAllRays(warmup, width, rayResults);
+
+            uint64_t steps = 0;
+            auto start = std::chrono::steady_clock::now();
+            for (const CameraPose& pose : path) {
+                Player player(pose.x, pose.y, pose.angle, 90);
+                raycaster.castAllRays(player, width, rayResults);
+                steps += raycaster.getLastCastSteps();
+            }
+            double seconds = secondsSince(start);
+
+            double rays = static_cast<double>(width) * path.size();
+            std::printf("%s    {\"map\": \"%s\", \"width\": %d, \"max_ray_distance\": %.1f, \"packet_lanes\": %d, "
+                        "\"distance_field\": %s, \"frames\": %zu, \"seconds\": %.6f, \"rays_per_sec\": %.1f, \"ns_per_ray\": %.3f, "
+                        "\"steps_per_ray\": %.3f}",
+                        first ? "" : ",\n", mapName, width, maxDistance, raycaster.getPacketLanes(),
+                        distanceField ? "true" : "false", path.size(), seconds, rays / seconds, seconds * 1e9 / rays, steps / rays);
+            first = false;
+        }
+    }
+}
+
+// Standing still and turning in place, with and without the ray cache
+static void benchRayCache(const char* mapName, const WorldMap& worldMap, const BenchConfig& config,
+                          ThreadPool* pool, int width, float maxDistance, bool& first) {
+    std::vector<CameraPose> path = buildCameraPath(worldMap, 1);
+    std::vector<RayHit> rayResults;
+
+    const char* motions[] = { "static", "turning" };
+    for (int motion = 0; motion < 2; motion++) {
+        for (int cached = 0; cached < 2; cached++) {
+            Raycaster raycaster(worldMap);
+            raycaster.setThreadPool(pool);
+            raycaster.setMaxDistance(maxDistance);
+            raycaster.setRayCacheEnabled(cached != 0);
+            if (config.lanes > 0) {
+                raycaster.setPacketLanes(config.lanes);
+            }
+
+            // About 3 degrees per frame, a steady turn at 60 frames per second
+            float turnPerFrame = motion == 1 ? 0.05f : 0.0f;
+            Player warmup(path[0].x, path[0].y, path[0].angle, 90);
+            raycaster.castAllRays(warmup, width, rayResults);
+
+            uint64_t reused = 0;
+            auto start = std::chrono::steady_clock::now();
+            for (int frame = 1; frame <= config.frames; frame++) {
+                Player player(path[0].x, path[0].y, path[0].angle + frame * turnPerFrame, 90);
+                raycaster.castAllRays(player, width, rayResults);
+                reused += raycaster.getLastReusedColumns();
+            }
+            double seconds = secondsSince(start);
+
+            double rays = static_cast<double>(width) * config.frames;
+            std::printf("%s    {\"map\": \"%s\", \"motion\": \"%s\", \"ray_cache\": %s, \"width\": %d, "
+                        "\"max_ray_distance\": %.1f, \"frames\": %d, \"seconds\": %.6f, \"us_per_frame\": %.3f, "
+                        "\"reused_fraction\": %.3f}",
+                        first ? "" : ",\n", mapName, motions[motion], cached ? "true" : "false", width, maxDistance,
+                        config.frames, seconds, seconds * 1e6 / config.frames, reused / rays);
+            first = false;
+        }
+    }
+}
+
+// Many agents sharing one map, as one castViews batch and as one castAllRays per agent
+static void benchBatch(const char* mapName, const WorldMap& worldMap, const BenchConfig& config,
+                       ThreadPool* pool, int agents, int columns, float maxDistance, bool& first) {
+    std::vector<CameraPose> path = buildCameraPath(worldMap, agents);
+    std::vector<ViewPose> views;
+    for (const CameraPose& pose : path) {
+        views.push_back({ pose.x, pose.y, pose.angle, 90.0f });
+    }
+
+    Raycaster raycaster(worldMap);
+    raycaster.setThreadPool(pool);
+    raycaster.setMaxDistance(maxDistance);
+    if (config.lanes > 0) {
+        raycaster.setPacketLanes(config.lanes);
+    }
+
+    RayBatchHits hits;
+    std::vector<RayHit> rayResults;
+    raycaster.castViews(views.data(), agents, columns, hits);
+
+    const char* modes[] = { "cast_views", "cast_all_rays_per_agent" };
+    for (int mode = 0; mode < 2; mode++) {
+        auto start = std::chrono::steady_clock::now();
+        for (int frame = 0; frame < config.frames; frame++) {
+            if (mode == 0) {
+                raycaster.castViews(views.data(), agents, columns, hits);
+            } else {
+                for (const ViewPose& view : views) {
+                    Player player(view.x, view.y, view.angle, view.fieldOfView);
+                    raycaster.castAllRays(player, columns, rayResults);
+                }
+            }
+        }
+        double seconds = secondsSince(start);
+
+        double rays = static_cast<double>(agents) * columns * config.frames;
+        std::printf("%s    {\"map\": \"%s\", \"mode\": \"%s\", \"agents\": %d, \"columns\": %d, "
+                    "\"max_ray_distance\": %.1f, \"frames\": %d, \"seconds\": %.6f, \"rays_per_sec\": %.1f}",
+                    first ? "" : ",\n", mapName, modes[mode], agents, columns, maxDistance, config.frames,
+                    seconds, rays / seconds);
+        first = false;
+    }
+}
+
+// Random short segments between open cells, as NPC sight checks would make
+static void benchSegments(const char* mapName, const WorldMap& worldMap, const BenchConfig& config,
+                          ThreadPool* pool, int count, bool& first) {
+    std::vector<CameraPose> path = buildCameraPath(worldMap, count);
+    RandomNumberGenerator rng(config.seed);
+    std::vector<float> ax(count), ay(count), bx(count), by(count);
+    for (int i = 0; i < count; i++) {
+        const CameraPose& from = path[i];
+        const CameraPose& to = path[rng.randomInt(std::max(0, i - 64), std::min(count - 1, i + 64))];
+        ax[i] = from.x;
+        ay[i] = from.y;
+        bx[i] = to.x;
+        by[i] = to.y;
+    }
+
+    Raycaster raycaster(worldMap);
+    raycaster.setThreadPool(pool);
+    std::vector<uint8_t> visible(count);
+    std::vector<SegmentHit> hits(count);
+
+    for (int query = 0; query < 2; query++) {
+        auto start = std::chrono::steady_clock::now();
+        for (int frame = 0; frame < config.frames; frame++) {
+            if (query == 0) {
+                raycaster.testLinesOfSight(ax.data(), ay.data(), bx.data(), by.data(), count, visible.data());
+            } else {
+                raycaster.findWallsOnSegments(ax.data(), ay.data(), bx.data(), by.data(), count, hits.data());
+            }
+        }
+        double seconds = secondsSince(start);
+
+        int clear = 0;
+        for (int i = 0; i < count; i++) {
+            clear += query == 0 ? visible[i] : hits[i].wallType == 0;
+        }
+        double segments = static_cast<double>(count) * config.frames;
+        std::printf("%s    {\"map\": \"%s\", \"query\": \"%s\", \"segments\": %d, \"frames\": %d, "
+                    "\"seconds\": %.6f, \"ns_per_segment\": %.3f, \"clear_fraction\": %.3f}",
+                    first ? "" : ",\n", mapName, query == 0 ? "line_of_sight" : "first_wall", count,
+                    config.frames, seconds, seconds * 1e9 / segments, static_cast<double>(clear) / count);
+        first = false;
+    }
+}
+
+// True if the box overlaps a wall cell, which moveBox should never allow
+static bool boxInWall(const WorldMap& worldMap, float x, float y, float halfSize) {
+    int firstX = static_cast<int>(floor(x - halfSize));
+    int firstY = static_cast<int>(floor(y - halfSize));
+    int lastX = static_cast<int>(ceil(x + halfSize)) - 1;
+    int lastY = static_cast<int>(ceil(y + halfSize)) - 1;
+    for (int cellY = firstY; cellY <= lastY; cellY++) {
+        for (int cellX = firstX; cellX <= lastX; cellX++) {
+            if (worldMap.isWall(cellX, cellY)) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+// Entities wandering the maze at a fixed tick, turning away whenever a wall stops them
+static void benchMovement(const char* mapName, const WorldMap& worldMap, const BenchConfig& config,
+                          ThreadPool* pool, int count, float speed, bool& first) {
+    std::vector<CameraPose> path = buildCameraPath(worldMap, count);
+    RandomNumberGenerator rng(config.seed);
+    MovementBatch batch;
+    for (const CameraPose& pose : path) {
+        int entity = batch.add(pose.x, pose.y, pose.angle);
+        batch.speed[entity] = speed;
+        batch.turnRate[entity] = (rng.randomInt(0, 200) - 100) / 100.0f;
+    }
+
+    MovementSystem movement(worldMap);
+    movement.setThreadPool(pool);
+    const float tickSeconds = 1.0f / 60.0f;
+    int ticks = config.frames * 4;
+    int blockedMoves = 0;
+
+    auto start = std::chrono::steady_clock::now();
+    for (int tick = 0; tick < ticks; tick++) {
+        movement.update(batch, tickSeconds);
+        for (int i = 0; i < batch.size(); i++) {
+            if (batch.blocked[i]) {
+                batch.setAngle(i, batch.angle[i] + 1.5707964f);
+                blockedMoves++;
+            }
+        }
+    }
+    double seconds = secondsSince(start);
+
+    int inWalls = 0;
+    for (int i = 0; i < batch.size(); i++) {
+        inWalls += boxInWall(worldMap, batch.x[i], batch.y[i], batch.halfSize[i]);
+    }
+    double moves = static_cast<double>(count) * ticks;
+    std::printf("%s    {\"map\": \"%s\", \"entities\": %d, \"ticks\": %d, \"speed\": %.1f, \"seconds\": %.6f, "
+                "\"ns_per_entity_tick\": %.3f, \"blocked_fraction\": %.3f, \"entities_in_walls\": %d}",
+                first ? "" : ",\n", mapName, count, ticks, speed, seconds, seconds * 1e9 / moves,
+                blockedMoves / moves, inWalls);
+    first = false;
+}
+
+// Point to point queries between open cells, A* against jump point search
+static void benchPathfinding(const char* mapName, const WorldMap& worldMap, const BenchConfig& config,
+                             int queries, bool& first) {
+    std::vector<CameraPose> path = buildCameraPath(worldMap, queries * 2);
+    RandomNumberGenerator rng(config.seed);
+    std::vector<int> starts(queries), ends(queries);
+    for (int i = 0; i < queries; i++) {
+        starts[i] = rng.randomInt(0, static_cast<int>(path.size()) - 1);
+        ends[i] = rng.randomInt(0, static_cast<int>(path.size()) - 1);
+    }
+
+    GridPathfinder pathfinder(worldMap);
+    std::vector<int> cells;
+    std::vector<float> aStarCosts(queries);
+    for (int pass = 0; pass < 2; pass++) {
+        PathAlgorithm algorithm = pass == 0 ? PathAlgorithm::A_STAR : PathAlgorithm::JUMP_POINT;
+        int found = 0;
+        int costMismatches = 0;
+        uint64_t expanded = 0;
+
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < queries; i++) {
+            const CameraPose& from = path[starts[i]];
+            const CameraPose& to = path[ends[i]];
+            bool ok = pathfinder.findPath(static_cast<int>(from.x), static_cast<int>(from.y),
+                                          static_cast<int>(to.x), static_cast<int>(to.y), cells, algorithm);
+            found += ok;
+            expanded += pathfinder.getLastExpanded();
+            if (pass == 0) {
+                aStarCosts[i] = pathfinder.getLastCost();
+            } else if (fabs(pathfinder.getLastCost() - aStarCosts[i]) > 1e-3f * std::max(1.0f, aStarCosts[i])) {
+                costMismatches++;
+            }
+        }
+        double seconds = secondsSince(start);
+
+        std::printf("%s    {\"map\": \"%s\", \"algorithm\": \"%s\", \"queries\": %d, \"seconds\": %.6f, "
+                    "\"us_per_query\": %.3f, \"expanded_per_query\": %.1f, \"found_fraction\": %.3f, "
+                    "\"cost_mismatches\": %d}",
+                    first ? "" : ",\n", mapName, pass == 0 ? "a_star" : "jump_point", queries, seconds,
+                    seconds * 1e6 / queries, static_cast<double>(expanded) / queries,
+                    static_cast<double>(found) / queries, costMismatches);
+        first = false;
+    }
+}
+
+/**
+ * Flow field toward the exit corner: full build, single cell edits
+ * repaired with update() and checked against a rebuild, then agents
+ * steered along it with the movement system.
+ */
+static void benchFlowField(const char* mapName, WorldMap worldMap, const BenchConfig& config,
+                           ThreadPool* pool, int agents, bool& first) {
+    int goalX = worldMap.getWidth() - 2;
+    int goalY = worldMap.getHeight() - 2;
+
+    auto start = std::chrono::steady_clock::now();
+    FlowField field(worldMap.getGrid(), goalX, goalY);
+    double buildSeconds = secondsSince(start);
+
+    // Toggle cells along the camera path and put them back, so the map
+    // ends where it started
+    const int edits = 64;
+    std::vector<CameraPose> path = buildCameraPath(worldMap, edits);
+    int mismatches = 0;
+    start = std::chrono::steady_clock::now();
+    for (int round = 0; round < 2; round++) {
+        for (const CameraPose& pose : path) {
+            int x = static_cast<int>(pose.x);
+            int y = static_cast<int>(pose.y);
+            uint8_t& cell = worldMap.editGrid().row(y)[x];
+            cell = cell == 0 ? 1 : 0;
+            field.update(worldMap.getGrid(), x, y, x + 1, y + 1);
+        }
+    }
+    double updateSeconds = secondsSince(start);
+    FlowField rebuilt(worldMap.getGrid(), goalX, goalY);
+    for (int y = 0; y < worldMap.getHeight(); y++) {
+        for (int x = 0; x < worldMap.getWidth(); x++) {
+            mismatches += field.at(x, y) != rebuilt.at(x, y);
+        }
+    }
+
+    std::vector<CameraPose> spawns = buildCameraPath(worldMap, agents);
+    MovementBatch batch;
+    for (const CameraPose& pose : spawns) {
+        batch.add(pose.x, pose.y, 0.0f);
+    }
+    MovementSystem movement(worldMap);
+    movement.setThreadPool(pool);
+    const float tickSeconds = 1.0f / 60.0f;
+    int ticks = config.frames * 4;
+
+    start = std::chrono::steady_clock::now();
+    for (int tick = 0; tick < ticks; tick++) {
+        for (int i = 0; i < batch.size(); i++) {
+            float dirX;
+            float dirY;
+            bool moving = field.steer(batch.x[i], batch.y[i], dirX, dirY);
+            batch.speed[i] = moving ? 4.0f : 0.0f;
+            if (moving) {
+                batch.setAngle(i, atan2(dirY, dirX));
+            }
+        }
+        movement.update(batch, tickSeconds);
+    }
+    double steerSeconds = secondsSince(start);
+
+    uint32_t startDistance = 0;
+    uint32_t endDistance = 0;
+    for (int i = 0; i < batch.size(); i++) {
+        startDistance += std::min(field.at(static_cast<int>(spawns[i].x), static_cast<int>(spawns[i].y)), 1u << 20);
+        endDistance += std::min(field.at(static_cast<int>(batch.x[i]), static_cast<int>(batch.y[i])), 1u << 20);
+    }
+
+    int cells = worldMap.getWidth() * worldMap.getHeight();
+    std::printf("%s    {\"map\": \"%s\", \"cells\": %d, \"build_ms\": %.3f, \"update_us\": %.3f, "
+                "\"update_mismatches\": %d, \"agents\": %d, \"ticks\": %d, \"ns_per_agent_tick\": %.3f, "
+                "\"cells_advanced_per_agent\": %.2f}",
+                first ? "" : ",\n", mapName, cells, buildSeconds * 1e3, updateSeconds * 1e6 / (edits * 2),
+                mismatches, agents, ticks, steerSeconds * 1e9 / (static_cast<double>(agents) * ticks),
+                (static_cast<double>(startDistance) - endDistance) / agents);
+    first = false;
+}
+
+// Wall columns drawn into an offscreen XRGB buffer the way GameView's framebuffer path does
+static void benchWallRendering(const char* mapName, const WorldMap& worldMap, const BenchConfig& config,
+                               ThreadPool* pool, int width, int height, bool& first) {
+    std::vector<CameraPose> path = buildCameraPath(worldMap, config.frames);
+    std::vector<RayHit> rayResults;
+    std::vector<uint32_t> pixels(static_cast<size_t>(width) * height);
+    WallTextureAtlas wallTextures;
+
+    Raycaster raycaster(worldMap);
+    raycaster.setThreadPool(pool);
+
+    for (int textured = 0; textured < 2; textured++) {
+        double seconds = 0.0;
+        for (const CameraPose& pose : path) {
+            Player player(pose.x, pose.y, pose.angle, 90);
+            raycaster.castAllRays(player, width, rayResults);
+
+            auto start = std::chrono::steady_clock::now();
+            for (int x = 0; x < width; x++) {
+                const RayHit& ray = rayResults[x];
+                float lineHeight = ray.distance > 0.01f ? 360.0f / ray.distance : height;
+                float wallTop = (height - lineHeight) / 2.0f;
+                int firstRow = std::max(static_cast<int>(wallTop + 0.5f), 0);
+                int endRow = std::min(static_cast<int>(wallTop + lineHeight + 0.5f), height);
+
+                if (textured) {
+                    float u = WallTextureAtlas::wallU(ray.hitX, ray.hitY, ray.hitVerticalWall, ray.rayDirX, ray.rayDirY);
+                    wallTextures.drawColumn(pixels.data() + x, width, firstRow, endRow, wallTop, lineHeight, ray.wallType, u);
+                } else {
+                    for (int y = firstRow; y < endRow; y++) {
+                        pixels[static_cast<size_t>(y) * width + x] = 0x646464;
+                    }
+                }
+            }
+            seconds += secondsSince(start);
+        }
+
+        std::printf("%s    {\"map\": \"%s\", \"pass\": \"%s\", \"width\": %d, \"height\": %d, \"frames\": %zu, "
+                    "\"seconds\": %.6f, \"ms_per_frame\": %.3f}",
+                    first ? "" : ",\n", mapName, textured ? "textured_walls" : "flat_walls", width, height, path.size(),
+                    seconds, seconds * 1e3 / path.size());
+        first = false;
+    }
+
+    // Floor and ceiling over the whole frame, rows spread over the pool
+    FloorCaster floorCaster(wallTextures);
+    floorCaster.setThreadPool(pool);
+    auto start = std::chrono::steady_clock::now();
+    for (const CameraPose& pose : path) {
+        floorCaster.draw(pixels.data(), width, width, height, pose.x, pose.y, pose.angle, 90.0f, 360.0f);
+    }
+    double seconds = secondsSince(start);
+    std::printf(",\n    {\"map\": \"%s\", \"pass\": \"floor_ceiling\", \"width\": %d, \"height\": %d, \"frames\": %zu, "
+                "\"seconds\": %.6f, \"ms_per_frame\": %.3f}",
+                mapName, width, height, path.size(), seconds, seconds * 1e3 / path.size());
+}
+
+// Sprites scattered over the open cells, drawn over the cast walls each frame of the camera path
+static void benchSprites(const char* mapName, const WorldMap& worldMap, const BenchConfig& config, ThreadPool* pool,
+                         int width, int height, int spriteCount, bool& first) {
+    std::vector<CameraPose> path = buildCameraPath(worldMap, config.frames);
+    std::vector<RayHit> rayResults;
+    std::vector<float> columnDepths(width);
+    std::vector<uint32_t> pixels(static_cast<size_t>(width) * height);
+
+    RandomNumberGenerator rng(config.seed, RandomEngine::XOSHIRO256);
+    SpritePool sprites;
+    while (sprites.size() < spriteCount) {
+        int cellX = rng.randomInt(0, worldMap.getWidth() - 1);
+        int cellY = rng.randomInt(0, worldMap.getHeight() - 1);
+        if (!worldMap.isWall(cellX, cellY)) {
+            sprites.add(cellX + 0.5f, cellY + 0.5f, static_cast<uint8_t>(sprites.size() % SPRITE_TYPE_COUNT));
+        }
+    }
+
+    Raycaster raycaster(worldMap);
+    raycaster.setThreadPool(pool);
+    raycaster.setMaxDistance(64.0f);
+    SpriteTextureAtlas spriteTextures;
+    SpriteRenderer spriteRenderer(spriteTextures);
+    spriteRenderer.setThreadPool(pool);
+
+    double seconds = 0.0;
+    long long visible = 0;
+    for (const CameraPose& pose : path) {
+        Player player(pose.x, pose.y, pose.angle, 90);
+        raycaster.castAllRays(player, width, rayResults);
+        for (int x = 0; x < width; x++) {
+            columnDepths[x] = rayResults[x].distance;
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        spriteRenderer.draw(pixels.data(), width, width, height, columnDepths.data(), sprites, pose.x, pose.y,
+                            pose.angle, 90.0f, 360.0f);
+        seconds += secondsSince(start);
+        visible += spriteRenderer.getLastVisible();
+    }
+
+    std::printf("%s    {\"map\": \"%s\", \"sprites\": %d, \"width\": %d, \"height\": %d, \"frames\": %zu, "
+                "\"visible_per_frame\": %.1f, \"ms_per_frame\": %.3f, \"ns_per_sprite\": %.2f}",
+                first ? "" : ",\n", mapName, spriteCount, width, height, path.size(),
+                static_cast<double>(visible) / path.size(), seconds * 1e3 / path.size(),
+                seconds * 1e9 / (static_cast<double>(path.size()) * spriteCount));
+    first = false;
+}
+
+/**
+ * Doors opening and closing near a still camera, one per frame, with the
+ * distance field, a flow field and the ray cache kept current either by
+ * WorldMap::setCell and flushEdits or by rebuilding them all. Every
+ * frame's rays are checked against a cast without the cache, and the
+ * fields against fresh builds at the end.
+ */
+static void benchMapEdits(const char* mapName, const WorldMap& worldMap, const BenchConfig& config,
+                          ThreadPool* pool, int width, float maxDistance, bool& first) {
+    CameraPose camera = buildCameraPath(worldMap, 3)[1];
+    int cameraX = static_cast<int>(camera.x);
+    int cameraY = static_cast<int>(camera.y);
+
+    // Doors in view: open cells part way along rays spread across the screen
+    std::vector<RayHit> rayResults;
+    Raycaster probe(worldMap);
+    probe.setMaxDistance(maxDistance);
+    probe.castAllRays(Player(camera.x, camera.y, camera.angle, 90), width, rayResults);
+    std::vector<std::pair<int, int>> doors;
+    for (int column = 0; column < width; column += std::max(width / 32, 1)) {
+        const RayHit& ray = rayResults[column];
+        int x = static_cast<int>(floor(camera.x + ray.rayDirX * ray.distance * 0.6f));
+        int y = static_cast<int>(floor(camera.y + ray.rayDirY * ray.distance * 0.6f));
+        bool known = std::find(doors.begin(), doors.end(), std::make_pair(x, y)) != doors.end();
+        if ((x != cameraX || y != cameraY) && !worldMap.isWall(x, y) && !known) {
+            doors.emplace_back(x, y);
+        }
+    }
+    if (doors.empty()) {
+        return;
+    }
+    int goalX = worldMap.getWidth() - 2;
+    int goalY = worldMap.getHeight() - 2;
+
+    const char* modes[] = { "regions", "full" };
+    for (int mode = 0; mode < 2; mode++) {
+        WorldMap map = worldMap;
+        DistanceField distanceField(map.getGrid());
+        FlowField flowField(map.getGrid(), goalX, goalY);
+        Raycaster raycaster(map);
+        raycaster.setThreadPool(pool);
+        raycaster.setMaxDistance(maxDistance);
+        raycaster.setDistanceField(&distanceField);
+        raycaster.setRayCacheEnabled(true);
+        Raycaster reference(map);
+        reference.setMaxDistance(maxDistance);
+        reference.setDistanceField(&distanceField);
+        if (mode == 0) {
+            map.addEditListener(&distanceField);
+            map.addEditListener(&flowField);
+            map.addEditListener(&raycaster);
+        }
+
+        Player player(camera.x, camera.y, camera.angle, 90);
+        std::vector<RayHit> expected;
+        raycaster.castAllRays(player, width, rayResults);
+
+        double seconds = 0.0;
+        uint64_t reused = 0;
+        int rayMismatches = 0;
+        for (int frame = 0; frame < config.frames; frame++) {
+            int x = doors[frame % doors.size()].first;
+            int y = doors[frame % doors.size()].second;
+
+            auto start = std::chrono::steady_clock::now();
+            map.setCell(x, y, map.isWall(x, y) ? 0 : 2);
+            map.flushEdits();
+            if (mode == 1) {
+                distanceField.build(map.getGrid());
+                flowField.build(map.getGrid(), goalX, goalY);
+                raycaster.invalidateRayCache();
+            }
+            raycaster.castAllRays(player, width, rayResults);
+            seconds += secondsSince(start);
+            reused += raycaster.getLastReusedColumns();
+
+            // Skipping lands on other cells once the field changes, which moves distances by rounding
+            reference.castAllRays(player, width, expected);
+            for (int column = 0; column < width; column++) {
+                float error = fabs(rayResults[column].distance - expected[column].distance);
+                rayMismatches += error > 1e-4f * expected[column].distance ||
+                                 rayResults[column].wallType != expected[column].wallType;
+            }
+        }
+
+        DistanceField rebuiltDistances(map.getGrid());
+        FlowField rebuiltFlow(map.getGrid(), goalX, goalY);
+        int fieldMismatches = 0;
+        for (int y = 0; y < map.getHeight(); y++) {
+            for (int x = 0; x < map.getWidth(); x++) {
+                fieldMismatches += distanceField.at(x, y) != rebuiltDistances.at(x, y);
+                fieldMismatches += flowField.at(x, y) != rebuiltFlow.at(x, y);
+            }
+        }
+
+        std::printf("%s    {\"map\": \"%s\", \"updates\": \"%s\", \"width\": %d, \"max_ray_distance\": %.1f, "
+                    "\"doors\": %zu, \"frames\": %d, \"us_per_frame\": %.3f, \"reused_fraction\": %.3f, "
+                    "\"ray_mismatches\": %d, \"field_mismatches\": %d}",
+                    first ? "" : ",\n", mapName, modes[mode], width, maxDistance, doors.size(), config.frames,
+                    seconds * 1e6 / config.frames, static_cast<double>(reused) / (static_cast<double>(width) * config.frames),
+                    rayMismatches, fieldMismatches);
+        first = false;
+    }
+}
+
+static bool parseArguments(int argc, char** argv, BenchConfig& config) {
+    for (int i = 1; i < argc; i++) {
+        bool hasValue = i + 1 < argc;
+        if (std::strcmp(argv[i], "--frames") == 0 && hasValue) {
+            config.frames = std::max(1, std::atoi(argv[++i]));
+        } else if (std::strcmp(argv[i], "--threads") == 0 && hasValue) {
+            config.threads = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--lanes") == 0 && hasValue) {
+            config.lanes = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--seed") == 0 && hasValue) {
+            config.seed = static_cast<unsigned int>(std::strtoul(argv[++i], nullptr, 10));
+        } else if (std::strcmp(argv[i], "--quick") == 0) {
+            config.quick = true;
+        } else {
+            std::fprintf(stderr, "Usage: %s [--frames N] [--threads N] [--lanes N] [--seed N] [--quick]\n", argv[0]);
+            return false;
+        }
+    }
+    return true;
+}
+
+int main(int argc, char** argv) {
+    BenchConfig config;
+    if (!parseArguments(argc, argv, config)) {
+        return 1;
+    }
+    if (config.quick) {
+        config.frames = std::min(config.frames, 8);
+    }
+
+    std::vector<int> mazeSizes = config.quick ? std::vector<int>{ 63, 255 } : std::vector<int>{ 63, 255, 1023 };
+    std::vector<int> packedMazeSizes = config.quick ? std::vector<int>{ 1023 } : std::vector<int>{ 1023, 4095, 10001 };
+    std::vector<int> widths = config.quick ? std::vector<int>{ 640, 1920 }
+                                           : std::vector<int>{ 640, 1280, 1920, 2560, 3840, 7680 };
+    std::vector<float> distances = config.quick ? std::vector<float>{ 6.0f, 64.0f }
+                                                : std::vector<float>{ 6.0f, 16.0f, 64.0f, 256.0f };
+
+    ThreadPool pool(config.threads);
+
+    std::printf("{\n");
+    std::printf("  \"config\": {\"seed\": %u, \"frames\": %d, \"threads\": %d, \"cpu_packet_lanes\": %d},\n",
+                config.seed, config.frames, pool.getThreadCount(), detectPacketLanes());
+
+    // Generation, keeping the largest maze of each kind for the casting runs
+    std::vector<std::vector<int>> depthFirstMaze;
+    std::vector<std::vector<int>> recursiveDivisionMaze;
+    bool first = true;
+    std::printf("  \"generation\": [\n");
+    for (int size : mazeSizes) {
+        depthFirstMaze = generateTimed<DepthFirstMazeGenerator>("depth_first", size, config.seed, first);
+        recursiveDivisionMaze = generateTimed<RecursiveDivisionMazeGenerator>("recursive_division", size, config.seed, first);
+    }
+    for (int size : packedMazeSizes) {
+        generatePackedTimed(size, config.seed, first);
+    }
+    for (int size : mazeSizes) {
+        generateTiledTimed("depth_first_tiled", TiledMazeAlgorithm::DEPTH_FIRST, size, config.seed, &pool, first);
+        generateTiledTimed("recursive_division_tiled", TiledMazeAlgorithm::RECURSIVE_DIVISION, size, config.seed, &pool, first);
+    }
+    std::printf("\n  ],\n");
+
+    first = true;
+    std::printf("  \"maze_file\": [\n");
+    benchMazeFile("grid_bytes", depthFirstMaze, MazeFileEncoding::GRID_BYTES, first);
+    benchMazeFile("bits", depthFirstMaze, MazeFileEncoding::BITS, first);
+    std::printf("\n  ],\n");
+
+    WorldMap depthFirstMap(depthFirstMaze, depthFirstMaze.size(), depthFirstMaze[0].size());
+    WorldMap recursiveDivisionMap(recursiveDivisionMaze, recursiveDivisionMaze.size(), recursiveDivisionMaze[0].size());
+
+    std::vector<std::vector<int>> arena = buildOpenArena(mazeSizes.back(), config.seed);
+    WorldMap arenaMap(arena, arena.size(), arena[0].size());
+    DistanceField arenaField(arenaMap.getGrid());
+
+    first = true;
+    std::printf("  \"casting\": [\n");
+    benchCasting("depth_first", depthFirstMap, config, &pool, widths, distances, first);
+    benchCasting("recursive_division", recursiveDivisionMap, config, &pool, widths, distances, first);
+    benchCasting("open_arena", arenaMap, config, &pool, widths, distances, first);
+    benchCasting("open_arena", arenaMap, config, &pool, widths, distances, first, &arenaField);
+    std::printf("\n  ],\n");
+
+    first = true;
+    std::printf("  \"ray_cache\": [\n");
+    benchRayCache("depth_first", depthFirstMap, config, &pool, widths.back(), distances.back(), first);
+    benchRayCache("open_arena", arenaMap, config, &pool, widths.back(), distances.back(), first);
+    std::printf("\n  ],\n");
+
+    first = true;
+    std::printf("  \"batch\": [\n");
+    benchBatch("depth_first", depthFirstMap, config, &pool, 256, 64, 16.0f, first);
+    benchBatch("open_arena", arenaMap, config, &pool, 256, 64, 16.0f, first);
+    std::printf("\n  ],\n");
+
+    first = true;
+    std::printf("  \"segments\": [\n");
+    benchSegments("depth_first", depthFirstMap, config, &pool, 16384, first);
+    benchSegments("open_arena", arenaMap, config, &pool, 16384, first);
+    std::printf("\n  ],\n");
+
+    // 60 cells a second is a full cell per tick, fast enough to tunnel with a point test
+    first = true;
+    std::printf("  \"movement\": [\n");
+    benchMovement("depth_first", depthFirstMap, config, &pool, 4096, 4.0f, first);
+    benchMovement("depth_first", depthFirstMap, config, &pool, 4096, 60.0f, first);
+    benchMovement("open_arena", arenaMap, config, &pool, 4096, 4.0f, first);
+    std::printf("\n  ],\n");
+
+    first = true;
+    std::printf("  \"pathfinding\": [\n");
+    benchPathfinding("depth_first", depthFirstMap, config, 256, first);
+    benchPathfinding("open_arena", arenaMap, config, 256, first);
+    std::printf("\n  ],\n");
+
+    first = true;
+    std::printf("  \"flow_field\": [\n");
+    benchFlowField("depth_first", depthFirstMap, config, &pool, 4096, first);
+    benchFlowField("open_arena", arenaMap, config, &pool, 4096, first);
+    std::printf("\n  ],\n");
+
+    first = true;
+    std::printf("  \"map_edits\": [\n");
+    benchMapEdits("depth_first", depthFirstMap, config, &pool, widths.back(), distances.back(), first);
+    benchMapEdits("open_arena", arenaMap, config, &pool, widths.back(), distances.back(), first);
+    std::printf("\n  ],\n");
+
+    first = true;
+    std::printf("  \"sprites\": [\n");
+    benchSprites("depth_first", depthFirstMap, config, &pool, 1920, 1080, 65536, first);
+    benchSprites("open_arena", arenaMap, config, &pool, 1920, 1080, 4096, first);
+    benchSprites("open_arena", arenaMap, config, &pool, 1920, 1080, 65536, first);
+    std::printf("\n  ],\n");
+
+    first = true;
+    std::printf("  \"wall_rendering\": [\n");
+    benchWallRendering("depth_first", depthFirstMap, config, &pool, 1920, 1080, first);
+    std::printf("\n  ]\n}\n");
+
+    return 0;
+}
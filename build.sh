@@ -35,11 +35,15 @@ show_help() {
     echo "  --verbose     Enable verbose build output"
     echo "  --jobs N      Use N parallel jobs (default: $JOBS)"
     echo "  --debug       Build in Debug mode (default: Release)"
+    echo "  --lto         Build in RelWithLTO mode (Release with link time optimisation)"
+    echo "  --arch ARCH   Compile for -march=ARCH, e.g. native or x86-64-v3"
+    echo "  --pgo         Profile guided build: instrument, train with raycaster_bench, rebuild"
     echo ""
     echo -e "${YELLOW}Examples:${NC}"
     echo "  ./build.sh build"
     echo "  ./build.sh rebuild --verbose"
     echo "  ./build.sh build --jobs 8 --debug"
+    echo "  ./build.sh rebuild --lto --pgo --arch x86-64-v3"
 }
 
 # Function to clean build directory
@@ -61,11 +65,21 @@ build_project() {
     cd "$BUILD_DIR"
     
     # Configure
+    CMAKE_ARGS=(-DCMAKE_BUILD_TYPE="$BUILD_TYPE" -DRAYCASTER_ARCH="$ARCH")
     if [ "$VERBOSE" = true ]; then
-        cmake -DCMAKE_BUILD_TYPE="$BUILD_TYPE" -DCMAKE_VERBOSE_MAKEFILE=ON ..
+        CMAKE_ARGS+=(-DCMAKE_VERBOSE_MAKEFILE=ON)
+    fi
+
+    if [ "$PGO" = true ]; then
+        # Instrumented build, then a training run to record where the time goes
+        cmake "${CMAKE_ARGS[@]}" -DRAYCASTER_PGO=GENERATE ..
+        echo -e "${YELLOW}Building instrumented project and training...${NC}"
+        make -j"$JOBS" pgo-train
+        CMAKE_ARGS+=(-DRAYCASTER_PGO=USE)
     else
-        cmake -DCMAKE_BUILD_TYPE="$BUILD_TYPE" ..
+        CMAKE_ARGS+=(-DRAYCASTER_PGO=OFF)
     fi
+    cmake "${CMAKE_ARGS[@]}" ..
     
     # Build
     echo -e "${YELLOW}Building project...${NC}"
@@ -78,10 +92,13 @@ build_project() {
     cd ..
     echo -e "${GREEN}Build complete!${NC}"
     echo -e "${BLUE}Executable location: $BUILD_DIR/main${NC}"
+    echo -e "${BLUE}Benchmark location: $BUILD_DIR/raycaster_bench${NC}"
 }
 
 # Parse command line arguments
 VERBOSE=false
+PGO=false
+ARCH=""
 COMMAND=""
 
 while [[ $# -gt 0 ]]; do
@@ -98,6 +115,18 @@ while [[ $# -gt 0 ]]; do
             BUILD_TYPE="Debug"
             shift
             ;;
+        --lto)
+            BUILD_TYPE="RelWithLTO"
+            shift
+            ;;
+        --arch)
+            ARCH="$2"
+            shift 2
+            ;;
+        --pgo)
+            PGO=true
+            shift
+            ;;
         --help)
             show_help
             exit 0
@@ -0,0 +1,17 @@
+#pragma once
+
+#include <cstdint>
+
+/**
+ * @brief Number of global operator new calls made so far
+ *
+ * Debug builds (NDEBUG not defined) replace the global operator new and
+ * delete with versions that count every allocation, so the main loop can
+ * assert that a steady-state frame doesn't touch the heap. Allocations made
+ * through malloc, for example inside SDL, are not seen.
+ *
+ * Release builds keep the standard allocator and this always returns 0.
+ *
+ * @return Allocations since program start, from all threads
+ */
+uint64_t getHeapAllocationCount();
@@ -0,0 +1,101 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <string>
+#include "randomNumberGenerator.h"
+#include "mazeFile.h"
+
+/**
+ * @brief High-scale depth-first maze generator with one bit per cell
+ *
+ * Produces the same kind of maze as DepthFirstMazeGenerator (perfect maze,
+ * carved two cells at a time from (1,1), entrance and exit marked with wall
+ * type 2) but is laid out for mazes of 10k x 10k cells and beyond:
+ *
+ * - Walls live in a row-major bitset, 1 = wall. A cell is visited exactly
+ *   when its bit has been cleared, so the same bits serve as the visited set.
+ *   That is 1 bit per cell instead of the 4 bytes of std::vector<int>.
+ * - The random exploration order is one pick from a table of all 24
+ *   orderings of the four directions, instead of shuffling a new vector
+ *   for every step.
+ * - The backtracking stack holds uint32_t cell indices and is reserved up
+ *   front for the worst case, so generation never reallocates.
+ *
+ * Randomness comes from the PCG32 engine rather than MT19937 and is
+ * consumed differently than in DepthFirstMazeGenerator, so the same seed
+ * gives a different (equally valid) maze.
+ */
+class BitPackedDepthFirstMazeGenerator {
+private:
+    int width, height;
+
+    // Row-major wall bits, bit (y * width + x)
+    std::vector<uint64_t> walls;
+
+    std::vector<uint32_t> stack;
+
+    RandomNumberGenerator rng;
+
+    // Seed recorded in saved mazes, 0 when seeded from the clock
+    unsigned int seed;
+
+    /**
+     * @brief All 24 permutations of the directions North, East, South, West
+     *
+     * Direction d moves by (dx[d], dy[d]) with the same mapping as
+     * DepthFirstMazeGenerator: 0 = North, 1 = East, 2 = South, 3 = West.
+     */
+    static const uint8_t directionOrders[24][4];
+
+    bool testWall(uint64_t index) const { return (walls[index >> 6] >> (index & 63)) & 1; }
+    void clearWall(uint64_t index) { walls[index >> 6] &= ~(uint64_t(1) << (index & 63)); }
+
+public:
+    /**
+     * @param w Width of the maze (should be odd for proper structure)
+     * @param h Height of the maze (should be odd for proper structure)
+     * @param seed Random seed for reproducible mazes (0 = use current time)
+     * @throws std::invalid_argument if the maze has more cells than fit in a uint32_t index
+     */
+    BitPackedDepthFirstMazeGenerator(int w, int h, unsigned int seed = 0);
+
+    /**
+     * @brief Generate the maze, same algorithm as DepthFirstMazeGenerator::generateMaze
+     */
+    void generateMaze();
+
+    /**
+     * @brief Whether (x, y) is a wall, out of range counts as wall
+     *
+     * The entrance (0, 1) and exit (width-1, height-2) are reported as walls,
+     * they are only told apart as wall type 2 by getWallType().
+     */
+    bool isWall(int x, int y) const;
+
+    /**
+     * @brief Cell value in the DepthFirstMazeGenerator convention: 0 path, 1 wall, 2 entrance/exit
+     */
+    int getWallType(int x, int y) const;
+
+    /**
+     * @brief Expand into the nested vector format used by WorldMap
+     *
+     * Only sensible for maps small enough to hold at 4 bytes per cell.
+     */
+    std::vector<std::vector<int>> toMaze() const;
+
+    // Raw bitset, width * height bits in row-major order
+    const std::vector<uint64_t>& getPackedMaze() const;
+
+    int getWidth() const;
+    int getHeight() const;
+
+    /**
+     * @brief Save as a BITS maze file, the wall bits are written as they are
+     *
+     * The entrance and exit markers are not part of the bits, so a loaded
+     * maze has plain walls there.
+     */
+    bool writeBinary(const std::string& path) const;
+};
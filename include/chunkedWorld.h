@@ -0,0 +1,149 @@
+#pragma once
+
+#include "game.h"
+#include "depthFirstMazeGenerator.h"
+
+#include <vector>
+#include <list>
+#include <deque>
+#include <unordered_map>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <cmath>
+#include <algorithm>
+
+/**
+ * @brief Unbounded maze made of fixed-size chunks generated on demand
+ *
+ * Every chunk is a DepthFirstMazeGenerator maze of chunkSize + 1 cells
+ * seeded from (seed, chunkX, chunkY), so any chunk can be rebuilt at any
+ * time and always comes out the same. A chunk owns its west column and
+ * north row of walls and opens one seam cell in each, which joins it to
+ * its west and north neighbours; the east and south walls are the
+ * neighbours' own. All chunks are therefore connected, with loops at
+ * chunk scale.
+ *
+ * The renderer never sees chunks. A square window of windowChunks x
+ * windowChunks chunks around the player is copied into one ordinary
+ * WorldMap, so the raycaster DDA, collision and minimap keep working on a
+ * flat grid and cross chunk boundaries at no cost. When the player leaves
+ * the centre chunk the window is re-centred and the player shifted by the
+ * same amount, which also keeps player coordinates small and float
+ * precision intact however far they walk. Rays see at least
+ * chunkSize * (windowChunks / 2) cells before the window edge.
+ *
+ * Chunks live in an LRU cache of fixed capacity, so memory stays constant.
+ * A background thread generates chunks ahead of the player along the view
+ * direction; a chunk that is still missing when the window moves is
+ * generated on the spot.
+ */
+class ChunkedWorld {
+public:
+    struct ChunkCoord {
+        int32_t x;
+        int32_t y;
+    };
+
+private:
+    struct Chunk {
+        ChunkCoord coord;
+        std::vector<uint8_t> cells; // chunkSize * chunkSize, row-major
+    };
+
+    uint32_t seed;
+    int chunkSize;
+    int windowChunks;
+    size_t cacheCapacity;
+
+    WorldMap window;
+    ChunkCoord windowCentre;
+
+    // Most recently used chunk at the front
+    std::list<Chunk> chunks;
+    std::unordered_map<uint64_t, std::list<Chunk>::iterator> chunkIndex;
+    std::mutex cacheMutex;
+
+    std::thread prefetchThread;
+    std::deque<ChunkCoord> prefetchQueue;
+    std::mutex prefetchMutex;
+    std::condition_variable prefetchReady;
+    bool stopping;
+
+    // Last prefetch request, so the same ring isn't queued every tick
+    ChunkCoord lastPrefetchCentre;
+    int lastPrefetchStepX;
+    int lastPrefetchStepY;
+
+    static uint64_t chunkKey(ChunkCoord coord) {
+        return (static_cast<uint64_t>(static_cast<uint32_t>(coord.x)) << 32) | static_cast<uint32_t>(coord.y);
+    }
+
+    // SplitMix64 of the seed, chunk and a per-use salt
+    uint64_t chunkHash(ChunkCoord coord, uint64_t salt) const;
+
+    // Pure function of (seed, coord), safe to run on any thread
+    void generateChunk(ChunkCoord coord, std::vector<uint8_t>& cells) const;
+
+    // Copies out a cached chunk and marks it recently used, false if not resident
+    bool copyCachedChunk(ChunkCoord coord, std::vector<uint8_t>& cells);
+
+    bool isCached(ChunkCoord coord);
+
+    void insertChunk(ChunkCoord coord, std::vector<uint8_t>&& cells);
+
+    void prefetchLoop();
+
+    /**
+     * @brief Queue the ring of chunks the window would take in next
+     *
+     * Looks one chunk past the window edge on each axis the player is
+     * facing along, so walking forward finds those chunks already built.
+     */
+    void requestPrefetch(float angle);
+
+    ChunkCoord chunkOf(float worldCellX, float worldCellY) const {
+        return { static_cast<int32_t>(std::floor(worldCellX / chunkSize)),
+                 static_cast<int32_t>(std::floor(worldCellY / chunkSize)) };
+    }
+
+    void rebuildWindow(ChunkCoord centre);
+
+public:
+    /**
+     * @param seed World seed, the same seed always gives the same world
+     * @param chunkSize Cells along a chunk edge, rounded up to even and at least 4
+     * @param windowChunks Chunks along the resident window edge, rounded up to odd
+     * @param cacheCapacity Most chunks kept in memory, at least the window plus one prefetch ring
+     */
+    ChunkedWorld(unsigned int seed, int chunkSize = 32, int windowChunks = 3, size_t cacheCapacity = 64);
+
+    ~ChunkedWorld();
+
+    ChunkedWorld(const ChunkedWorld&) = delete;
+    ChunkedWorld& operator=(const ChunkedWorld&) = delete;
+
+    // The resident window, valid for the lifetime of this object
+    const WorldMap& getWorldMap() const { return window; }
+
+    // World cell of window cell (0, 0)
+    int64_t getOriginX() const { return static_cast<int64_t>(windowCentre.x - windowChunks / 2) * chunkSize; }
+    int64_t getOriginY() const { return static_cast<int64_t>(windowCentre.y - windowChunks / 2) * chunkSize; }
+
+    int getChunkSize() const { return chunkSize; }
+
+    size_t getResidentChunkCount();
+
+    /**
+     * @brief Follow the player, call once per simulation tick
+     *
+     * Re-centres the window when the player has left the centre chunk,
+     * moving them by the same offset so they stay on the same world cell,
+     * and queues prefetches along their view direction.
+     *
+     * @return true if the window moved and map caches need refreshing
+     */
+    bool update(Player& player);
+};
@@ -2,7 +2,9 @@
 
 #include <vector>
 #include <stack>
+#include <string>
 #include "randomNumberGenerator.h"
+#include "mazeFile.h"
 
 /**
  * @brief Maze generator using Depth-First Search algorithm with backtracking
@@ -36,6 +38,9 @@ private:
     
     // Random number generator for algorithm choices
     RandomNumberGenerator rng;
+
+    // Seed recorded in saved mazes, 0 when seeded from the clock or an external generator
+    unsigned int seed;
     
     /**
      * @brief Direction vectors for movement in 4 cardinal directions
@@ -179,4 +184,13 @@ public:
      * @param seed New seed value for the random number generator
      */
     void reseedRNG(unsigned int seed);
+
+    /**
+     * @brief Save the maze as a binary maze file
+     *
+     * @param path File to write
+     * @param encoding GRID_BYTES to memory-map on load, BITS for the smallest file
+     * @return false if the file could not be written
+     */
+    bool writeBinary(const std::string& path, MazeFileEncoding encoding = MazeFileEncoding::GRID_BYTES) const;
 };
\ No newline at end of file
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <SDL3/SDL.h>
+#include <iostream>
+
+#include "frameProfiler.h"
+
+// Where the top-down map is drawn
+enum class MinimapMode {
+    OVERLAY,    // Picture-in-picture in the game window
+    WINDOW,     // A second window, the original layout
+    OFF
+};
+
+/**
+ * @brief Owns SDL for the whole program and pumps its events
+ *
+ * SDL is initialised once here and quit once in the destructor, so
+ * create the manager before any window and let it outlive them all.
+ * GameWindow and MapWindow only create and destroy their own window and
+ * renderer.
+ *
+ * pumpEvents() is the only event loop. It handles quitting: the quit
+ * event, Escape, or closing the game window ends the run, while closing
+ * the minimap window only closes that window. Held movement keys are read
+ * afterwards from SDL's keyboard state (GameWindow::pollInput).
+ */
+class DisplayManager {
+private:
+    bool initialized;
+    bool running;
+    SDL_WindowID gameWindowID;
+    SDL_WindowID mapWindowID;
+    bool mapWindowCloseRequested;
+    FrameProfiler* profiler;
+
+public:
+    DisplayManager()
+        : initialized(false), running(false), gameWindowID(0), mapWindowID(0),
+          mapWindowCloseRequested(false), profiler(nullptr) {}
+
+    ~DisplayManager() {
+        if (initialized) {
+            SDL_Quit();
+        }
+    }
+
+    DisplayManager(const DisplayManager&) = delete;
+    DisplayManager& operator=(const DisplayManager&) = delete;
+
+    bool init();
+
+    // Windows whose close button is handled, 0 for none. Call once they are created
+    void setWindows(SDL_WindowID gameWindow, SDL_WindowID mapWindow) {
+        gameWindowID = gameWindow;
+        mapWindowID = mapWindow;
+    }
+
+    // Times the event pump. nullptr turns it off
+    void setProfiler(FrameProfiler* frameProfiler) {
+        profiler = frameProfiler;
+    }
+
+    bool isRunning() const {
+        return running;
+    }
+
+    // True once after the minimap window's close button was pressed
+    bool takeMapWindowCloseRequest() {
+        bool requested = mapWindowCloseRequested;
+        mapWindowCloseRequested = false;
+        return requested;
+    }
+
+    // Drains the SDL event queue, call once per frame on the main thread
+    void pumpEvents();
+};
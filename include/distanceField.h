@@ -0,0 +1,68 @@
+#pragma once
+
+#include "mapGrid.h"
+#include <vector>
+#include <cstdint>
+#include <algorithm>
+
+/**
+ * @brief Chebyshev distance from every map cell to the nearest wall
+ *
+ * Stored in the same flat layout as MapGrid, so a DDA can read it with the
+ * cell index it already has. A value d means every cell within d - 1 steps
+ * in x and y is empty, so a ray can cross that whole square in one jump
+ * (see Raycaster::setDistanceField). Walls, the border and row padding are
+ * 0. Distances are capped at MAX_DISTANCE, which bounds both the memory
+ * per cell and the area an edit can affect.
+ *
+ * Built with the two-pass 3x3 chamfer transform, which is exact for the
+ * Chebyshev metric. update() redoes only the square around edited cells,
+ * and as a MapEditListener the field keeps itself current with
+ * WorldMap::setCell edits.
+ */
+class DistanceField : public MapEditListener {
+public:
+    static constexpr uint8_t MAX_DISTANCE = 32;
+
+private:
+    std::vector<uint8_t> distances;
+    int width;
+    int height;
+    int stride;
+
+    uint8_t& cell(int x, int y) { return distances[(y + MapGrid::BORDER) * stride + (x + MapGrid::BORDER)]; }
+
+    /**
+     * @brief Recompute map cells [x0, x1) x [y0, y1)
+     *
+     * Cells outside the rectangle are read as they are. That is exact as
+     * long as they are still correct, which holds when the rectangle covers
+     * every cell within MAX_DISTANCE of a change.
+     */
+    void recompute(const MapGrid& grid, int x0, int y0, int x1, int y1);
+
+public:
+    DistanceField() : width(0), height(0), stride(0) {}
+
+    explicit DistanceField(const MapGrid& grid) : DistanceField() {
+        build(grid);
+    }
+
+    // Full rebuild, needed whenever the grid is replaced or resized
+    void build(const MapGrid& grid);
+
+    // Bring the field up to date after map cells in [x0, x1) x [y0, y1) changed
+    void update(const MapGrid& grid, int x0, int y0, int x1, int y1);
+
+    void onCellsChanged(const MapGrid& grid, const CellRect& cells) override;
+
+    // Same indexing as MapGrid::data()
+    const uint8_t* data() const { return distances.data(); }
+
+    uint8_t at(int x, int y) const { return distances[(y + MapGrid::BORDER) * stride + (x + MapGrid::BORDER)]; }
+
+    // Whether the field was built for a grid of this shape
+    bool matches(const MapGrid& grid) const {
+        return grid.getWidth() == width && grid.getHeight() == height && grid.getStride() == stride;
+    }
+};
@@ -0,0 +1,52 @@
+#pragma once
+
+#include "threadPool.h"
+#include "wallTextures.h"
+#include "floorSpan.h"
+#include "rayPacket.h"
+#include <algorithm>
+#include <cstddef>
+#include <math.h>
+
+/**
+ * @brief Textured floor and ceiling, cast one screen row at a time
+ *
+ * A floor row below the horizon sees the floor at one distance, the
+ * ceiling rows above it mirror that. The world position of a row's first
+ * pixel and the step between pixels are worked out once per row, then a
+ * SIMD span kernel (see floorSpan.h) textures the whole row. The mip level
+ * is picked per row from that step, so far rows read a small texture.
+ *
+ * Rows are split over the thread pool in blocks of ROWS_PER_TASK. Walls
+ * are drawn over the result afterwards, so every row is drawn in full.
+ */
+class FloorCaster {
+public:
+    static constexpr int ROWS_PER_TASK = 16;
+
+private:
+    const WallTextureAtlas& textures;
+    ThreadPool* threadPool;
+    bool wideSpans;
+
+    void drawSpan(const FloorSpanQuery& query) const;
+
+public:
+    // The atlas supplies the FLOOR_SLOT and CEILING_SLOT textures and must outlive the caster
+    explicit FloorCaster(const WallTextureAtlas& atlas)
+        : textures(atlas), threadPool(nullptr), wideSpans(detectPacketLanes() >= 8) {}
+
+    // Pool used to draw rows in parallel, nullptr draws on the calling thread
+    void setThreadPool(ThreadPool* pool) { threadPool = pool; }
+
+    /**
+     * @brief Fills a width x height XRGB frame with floor and ceiling
+     *
+     * projectionScale is the on-screen height of a wall one cell away, the
+     * same scale the walls are drawn with, so floor and walls meet. The
+     * camera matches Raycaster::castAllRays: screen column x looks along
+     * the view direction plus the camera plane offset for that column.
+     */
+    void draw(uint32_t* pixels, int pitch, int width, int height, float cameraX, float cameraY,
+              float angle, float fieldOfView, float projectionScale) const;
+};
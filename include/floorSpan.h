@@ -0,0 +1,89 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+
+/**
+ * @brief Horizontal span kernels for floor and ceiling casting
+ *
+ * Every pixel of a floor or ceiling row lies at the same distance from
+ * the camera, so its world position moves by a fixed step from one pixel
+ * to the next. A span kernel walks that line in SIMD registers, turns the
+ * positions into texel indices and writes the looked-up texels to the row.
+ *
+ * The 8 pixel kernel uses GCC/Clang vector extensions, two 4 lane vectors
+ * per iteration, and looks texels up one at a time. The 16 pixel kernel
+ * lives in its own translation unit built with AVX2, does two 8 lane
+ * hardware gathers per iteration, and is only called when the CPU reports
+ * AVX2 support (see detectPacketLanes).
+ */
+
+/**
+ * @brief One row span to texture
+ */
+struct FloorSpanQuery {
+    const uint32_t* texture;    ///< Column-major square texture, see WallTextureAtlas
+    int sizeBits;               ///< log2 of the texture size in texels
+    float startX;               ///< World position of the first pixel, truncated rather than floored so keep it >= 0
+    float startY;
+    float stepX;                ///< World step from one pixel to the next
+    float stepY;
+    uint32_t* pixels;           ///< First pixel of the span
+    int count;                  ///< Pixels in the span
+};
+
+void drawFloorSpan8(const FloorSpanQuery& query);
+
+#if defined(RAYCASTER_AVX2_KERNEL)
+void drawFloorSpan16(const FloorSpanQuery& query);
+#endif
+
+/**
+ * @brief Span walk shared by the kernels
+ *
+ * Each kernel instantiates this in its own translation unit with its own
+ * vector types and a Gather type providing load(texture, index, texels).
+ * Every iteration handles VECTORS vectors of LANES pixels, so independent
+ * lookups can overlap. It is static so a copy compiled with AVX2 can never
+ * be picked by the linker for a caller built without it.
+ *
+ * Positions are computed from the span start rather than accumulated, so
+ * long spans don't drift. Pixels past the last whole iteration take the
+ * scalar path.
+ */
+template<typename FloatV, typename IntV, int LANES, int VECTORS, typename Gather>
+static inline void traceFloorSpan(const FloorSpanQuery& query) {
+    const float scale = static_cast<float>(1 << query.sizeBits);
+    const int32_t mask = (1 << query.sizeBits) - 1;
+
+    FloatV laneOffsets;
+    for (int lane = 0; lane < LANES; lane++) {
+        laneOffsets[lane] = static_cast<float>(lane);
+    }
+
+    // Texel space start and step, one texture repeat per map cell
+    float startU = query.startX * scale;
+    float startV = query.startY * scale;
+    float stepU = query.stepX * scale;
+    float stepV = query.stepY * scale;
+
+    const int pixelsPerIteration = LANES * VECTORS;
+    int x = 0;
+    for (; x + pixelsPerIteration <= query.count; x += pixelsPerIteration) {
+        for (int vector = 0; vector < VECTORS; vector++) {
+            int first = x + vector * LANES;
+            FloatV pixel = laneOffsets + static_cast<float>(first);
+            IntV u = __builtin_convertvector(startU + pixel * stepU, IntV) & mask;
+            IntV v = __builtin_convertvector(startV + pixel * stepV, IntV) & mask;
+            IntV texels;
+            Gather::load(query.texture, (u << query.sizeBits) | v, texels);
+            std::memcpy(query.pixels + first, &texels, sizeof(texels));
+        }
+    }
+
+    for (; x < query.count; x++) {
+        int32_t u = static_cast<int32_t>(startU + x * stepU) & mask;
+        int32_t v = static_cast<int32_t>(startV + x * stepV) & mask;
+        query.pixels[x] = query.texture[(u << query.sizeBits) | v];
+    }
+}
@@ -0,0 +1,112 @@
+#pragma once
+
+#include "mapGrid.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <math.h>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Steps to one goal cell from every map cell, for any number of agents
+ *
+ * A breadth-first search out from the goal over the 4 straight moves,
+ * stored in the same flat layout as MapGrid. An agent finds its next cell
+ * by looking at its 4 neighbours for the one a step closer, so steering
+ * costs the same however many agents share the goal.
+ *
+ * update() repairs the field after cells change instead of searching the
+ * whole map again. The edited cells are cleared, and so is every cell
+ * that loses its last neighbour a step closer to the goal; those are
+ * refilled from the cells around them that are still correct, and the
+ * changes spread out from there as far as distances actually improve.
+ * As a MapEditListener the field repairs itself after WorldMap::setCell
+ * edits.
+ */
+class FlowField : public MapEditListener {
+public:
+    static constexpr uint32_t UNREACHABLE = UINT32_MAX;
+
+private:
+    // Distance, cell. Ordered smallest distance first by std::greater
+    typedef std::pair<uint32_t, int32_t> QueueEntry;
+
+    std::vector<uint32_t> distances;
+    std::vector<QueueEntry> queue;
+    std::vector<std::pair<int32_t, uint32_t>> cleared;   // Cell and its distance before update() cleared it
+    int width;
+    int height;
+    int stride;
+    int goalCell;
+    int neighbourOffsets[4];
+
+    void setShape(const MapGrid& grid) {
+        width = grid.getWidth();
+        height = grid.getHeight();
+        stride = grid.getStride();
+        neighbourOffsets[0] = -1;
+        neighbourOffsets[1] = 1;
+        neighbourOffsets[2] = -stride;
+        neighbourOffsets[3] = stride;
+    }
+
+    void pushCell(int cell, uint32_t distance) {
+        distances[cell] = distance;
+        queue.push_back({ distance, cell });
+        std::push_heap(queue.begin(), queue.end(), std::greater<QueueEntry>());
+    }
+
+    // Spreads queued distances out over open cells while they improve
+    void propagate(const uint8_t* cells);
+
+    // One more than the closest open neighbour with a distance, UNREACHABLE if none
+    uint32_t distanceFromNeighbours(const uint8_t* cells, int cell) const;
+
+public:
+    FlowField() : width(0), height(0), stride(0), goalCell(-1), neighbourOffsets{ 0, 0, 0, 0 } {}
+
+    FlowField(const MapGrid& grid, int goalX, int goalY) : FlowField() {
+        build(grid, goalX, goalY);
+    }
+
+    /**
+     * @brief Full search toward map cell (goalX, goalY)
+     *
+     * A goal that is a wall or outside the map leaves every cell UNREACHABLE.
+     */
+    void build(const MapGrid& grid, int goalX, int goalY);
+
+    /**
+     * @brief Brings the field up to date after map cells in [x0, x1) x [y0, y1) changed
+     *
+     * Exact for any edit, opening or closing cells, goal included. A grid
+     * of a different shape gets a full build.
+     */
+    void update(const MapGrid& grid, int x0, int y0, int x1, int y1);
+
+    void onCellsChanged(const MapGrid& grid, const CellRect& cells) override;
+
+    uint32_t at(int x, int y) const { return distances[(y + MapGrid::BORDER) * stride + (x + MapGrid::BORDER)]; }
+
+    // Same indexing as MapGrid::data(), UNREACHABLE for walls and cut off cells
+    const uint32_t* data() const { return distances.data(); }
+
+    // Flat index of the neighbour a step closer to the goal, -1 at the goal or with no way there
+    int nextCell(int cell) const;
+
+    /**
+     * @brief Unit direction from (x, y) toward the centre of the next cell on the way
+     *
+     * Heading for the next centre rather than along the grid axis lets a
+     * box sliding with WorldMap::moveBox get round corners. Returns false at
+     * the goal, in a wall, outside the map or with no way there.
+     */
+    bool steer(float x, float y, float& dirX, float& dirY) const;
+
+    // Whether the field was built for a grid of this shape
+    bool matches(const MapGrid& grid) const {
+        return grid.getWidth() == width && grid.getHeight() == height && grid.getStride() == stride;
+    }
+};
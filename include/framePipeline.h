@@ -0,0 +1,155 @@
+#pragma once
+
+#include "raycaster.h"
+#include "chunkedWorld.h"
+#include "frameScheduler.h"
+#include "tripleBuffer.h"
+
+#include <SDL3/SDL.h>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Everything the render side needs to draw one frame
+ *
+ * The player is a snapshot taken when the rays were cast, so the views
+ * always draw the pose the rays belong to.
+ */
+struct RenderFrame {
+    Player player;
+    std::vector<RayHit> rays;
+    int columnWidth;        // Resolution the rays were cast for, see ResolutionController
+    int rowHeight;
+    uint64_t ddaSteps;
+    uint64_t castStart;     // SDL performance counter around the cast, for FrameProfiler::addSample
+    uint64_t castEnd;
+    uint64_t mapVersion;    // Bumped whenever the map cells changed under the minimap
+
+    RenderFrame()
+        : player(0.0f, 0.0f, 0.0f, 0.0f), columnWidth(1), rowHeight(1), ddaSteps(0), castStart(0),
+          castEnd(0), mapVersion(0) {}
+};
+
+/**
+ * @brief Simulation and ray casting, either inline or on their own thread
+ *
+ * A simulation frame runs the fixed ticks that are due, casts the rays for
+ * the resulting pose and publishes both through a TripleBuffer of
+ * RenderFrames. The render side acquires the newest frame and draws it.
+ *
+ * Inline, simulateFrame() is called from the main loop before drawing,
+ * which is the old strictly sequential order. After start() a simulation
+ * thread does this instead, casting frame N + 1 while the main thread
+ * draws and presents frame N, so present and driver time overlap with
+ * casting. SDL is only ever called from the main thread; the simulation
+ * thread sees the keyboard through setInput().
+ *
+ * The simulation thread runs at most one frame ahead: it waits for the
+ * published frame to be picked up before starting the next, so it doesn't
+ * burn a core casting frames nobody will see. The wait parks the thread on
+ * a condition variable; the frame handoff itself never takes a lock.
+ *
+ * While the thread runs it owns the player, raycaster and thread pool it
+ * was given, and the map set with setEditedMap. The render side must only
+ * use the RenderFrame copies and must draw with a different thread pool.
+ */
+class FramePipeline {
+private:
+    Raycaster& raycaster;
+    Player& player;
+    ChunkedWorld* chunkedWorld;
+    WorldMap* editedMap;
+    FrameScheduler scheduler;
+    int screenWidth;
+
+    TripleBuffer<RenderFrame> frames;
+    uint64_t mapVersion;
+
+    std::atomic<uint32_t> heldKeys;
+    std::atomic<int> columnWidth;
+    std::atomic<int> rowHeight;
+
+    std::thread simulationThread;
+    std::atomic<bool> threaded;         // Set before the thread starts, which reads it too
+    std::atomic<bool> stopping;
+
+    // Only used to park a side that has nothing to do, never around frame data
+    std::mutex parkMutex;
+    std::condition_variable frameChanged;
+
+    void notifyFrameChanged();
+
+    void simulationLoop();
+
+public:
+    /**
+     * @param screenWidth Full resolution cast width; every frame slot is sized for it now
+     * @param chunkedWorld Map to re-centre on the player each tick, or nullptr for a fixed map.
+     *                     Re-centring rewrites the map, so it can't be combined with start()
+     *                     while anything on the render thread reads the map.
+     */
+    FramePipeline(Raycaster& raycaster, Player& player, double tickRate, int screenWidth,
+                  ChunkedWorld* chunkedWorld = nullptr)
+        : raycaster(raycaster), player(player), chunkedWorld(chunkedWorld), editedMap(nullptr), scheduler(tickRate),
+          screenWidth(screenWidth), mapVersion(0), heldKeys(0), columnWidth(1), rowHeight(1),
+          threaded(false), stopping(false) {
+        // Until the first frame is published getFrame() is the starting pose with no rays
+        for (int i = 0; i < 3; i++) {
+            frames.slot(i).player = player;
+            frames.slot(i).rays.reserve(screenWidth);
+        }
+    }
+
+    ~FramePipeline() {
+        stop();
+    }
+
+    FramePipeline(const FramePipeline&) = delete;
+    FramePipeline& operator=(const FramePipeline&) = delete;
+
+    /**
+     * Map whose setCell edits are flushed to its listeners after each
+     * frame's ticks, before the rays are cast, so every frame draws the
+     * edits made by its ticks. nullptr for none.
+     */
+    void setEditedMap(WorldMap* map) { editedMap = map; }
+
+    // PlayerInput bits applied on every tick until the next call
+    void setInput(uint32_t keys) { heldKeys.store(keys, std::memory_order_relaxed); }
+
+    // Internal resolution for the frames cast from now on
+    void setResolution(int newColumnWidth, int newRowHeight) {
+        columnWidth.store(std::max(newColumnWidth, 1), std::memory_order_relaxed);
+        rowHeight.store(std::max(newRowHeight, 1), std::memory_order_relaxed);
+    }
+
+    // Move simulation and casting onto their own thread
+    void start();
+
+    void stop();
+
+    bool isThreaded() const { return threaded.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Runs the due ticks, casts the rays and publishes the frame
+     *
+     * Called by the simulation thread once start()ed, otherwise by the main loop.
+     */
+    void simulateFrame();
+
+    /**
+     * @brief Makes the newest frame the one getFrame() returns
+     *
+     * When threaded, waits up to timeoutMs for the simulation thread to
+     * publish one. Returns false if there was no new frame, getFrame() is
+     * then still the previous one, or the constructor's starting pose with
+     * no rays if none has been published yet.
+     */
+    bool acquireFrame(double timeoutMs = 100.0);
+
+    const RenderFrame& getFrame() const { return frames.readSlot(); }
+};
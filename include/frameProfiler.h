@@ -0,0 +1,188 @@
+#pragma once
+
+#include <SDL3/SDL.h>
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <vector>
+
+// Parts of a frame the profiler keeps separate timings for
+enum class ProfileSection {
+    RAY_CASTING,
+    GAME_RENDER,
+    GRID_RENDER,
+    PLAYER_RENDER,
+    EVENTS,
+    PRESENT,
+    COUNT
+};
+
+/**
+ * @brief Per-frame timing of the hot paths, built on SDL_GetPerformanceCounter
+ *
+ * ScopedTimer objects add their elapsed time to the current frame's
+ * section totals. The last HISTORY frames are kept in a ring buffer for
+ * min/avg/p99 statistics, which GameWindow shows as an overlay, and can be
+ * written out as CSV when the program exits.
+ *
+ * With tracing enabled every timed scope is also recorded as a Chrome trace
+ * event (load the file in chrome://tracing or Perfetto). Trace storage is
+ * reserved up front and recording stops once it is full, so profiling never
+ * allocates during a frame.
+ */
+class FrameProfiler {
+public:
+    static constexpr int HISTORY = 240;
+    static constexpr int SECTION_COUNT = static_cast<int>(ProfileSection::COUNT);
+
+    struct Stats {
+        double minMs;
+        double avgMs;
+        double p99Ms;
+    };
+
+private:
+    struct FrameRecord {
+        double frameMs;
+        double sectionMs[SECTION_COUNT];
+        uint64_t ddaSteps;
+        int rays;
+    };
+
+    struct TraceEvent {
+        ProfileSection section;
+        uint64_t start;
+        uint64_t end;
+    };
+
+    uint64_t frequency;
+    uint64_t startCounter;
+    uint64_t frameStart;
+    bool inFrame;
+
+    FrameRecord current;
+    std::vector<FrameRecord> history;
+    int historyNext;
+    int historyCount;
+    uint64_t framesRecorded;
+
+    bool tracing;
+    size_t maxTraceEvents;
+    std::vector<TraceEvent> traceEvents;
+
+    // Scratch space for percentiles, sized once
+    std::vector<double> sortScratch;
+
+    double toMs(uint64_t ticks) const {
+        return static_cast<double>(ticks) * 1000.0 / frequency;
+    }
+
+    double toMicroseconds(uint64_t counter) const {
+        return static_cast<double>(counter - startCounter) * 1000000.0 / frequency;
+    }
+
+    template<typename Getter>
+    Stats computeStats(Getter value) {
+        Stats stats = { 0.0, 0.0, 0.0 };
+        if (historyCount == 0) {
+            return stats;
+        }
+
+        double sum = 0.0;
+        for (int i = 0; i < historyCount; i++) {
+            sortScratch[i] = value(history[i]);
+            sum += sortScratch[i];
+        }
+
+        int p99Index = std::min(historyCount - 1, static_cast<int>(historyCount * 0.99));
+        std::nth_element(sortScratch.begin(), sortScratch.begin() + p99Index, sortScratch.begin() + historyCount);
+        stats.p99Ms = sortScratch[p99Index];
+        stats.minMs = *std::min_element(sortScratch.begin(), sortScratch.begin() + historyCount);
+        stats.avgMs = sum / historyCount;
+        return stats;
+    }
+
+public:
+    FrameProfiler()
+        : frequency(SDL_GetPerformanceFrequency()), startCounter(SDL_GetPerformanceCounter()),
+          frameStart(0), inFrame(false), current(), history(HISTORY), historyNext(0), historyCount(0),
+          framesRecorded(0), tracing(false), maxTraceEvents(0), sortScratch(HISTORY) {}
+
+    static const char* getSectionName(ProfileSection section);
+
+    // Start keeping trace events, room for maxEvents is reserved now
+    void enableTracing(size_t maxEvents);
+
+    uint64_t now() const { return SDL_GetPerformanceCounter(); }
+
+    void beginFrame();
+
+    void endFrame();
+
+    void addSample(ProfileSection section, uint64_t start, uint64_t end);
+
+    // DDA cells visited and rays cast during the current frame
+    void setRayStats(uint64_t ddaSteps, int rays) {
+        current.ddaSteps = ddaSteps;
+        current.rays = rays;
+    }
+
+    Stats getFrameStats() {
+        return computeStats([](const FrameRecord& record) { return record.frameMs; });
+    }
+
+    Stats getSectionStats(ProfileSection section) {
+        int index = static_cast<int>(section);
+        return computeStats([index](const FrameRecord& record) { return record.sectionMs[index]; });
+    }
+
+    // DDA steps in the most recent finished frame
+    uint64_t getLastDdaSteps() const {
+        return history[(historyNext + HISTORY - 1) % HISTORY].ddaSteps;
+    }
+
+    // Length of the most recent finished frame, 0 before the first one
+    double getLastFrameMs() const {
+        return historyCount > 0 ? history[(historyNext + HISTORY - 1) % HISTORY].frameMs : 0.0;
+    }
+
+    double getLastSectionMs(ProfileSection section) const {
+        return historyCount > 0 ? history[(historyNext + HISTORY - 1) % HISTORY].sectionMs[static_cast<int>(section)] : 0.0;
+    }
+
+    // Average DDA steps per ray over the kept history
+    double getAverageStepsPerRay() const;
+
+    // One row per kept frame, oldest first
+    bool writeCsv(const char* path) const;
+
+    // Chrome trace event format, one complete ("X") event per timed scope
+    bool writeChromeTrace(const char* path) const;
+};
+
+/**
+ * @brief Adds the time between construction and destruction to a profiler section
+ *
+ * Does nothing when given a null profiler, so callers can time
+ * unconditionally and leave profiling switched off.
+ */
+class ScopedTimer {
+private:
+    FrameProfiler* profiler;
+    ProfileSection section;
+    uint64_t start;
+
+public:
+    ScopedTimer(FrameProfiler* profiler, ProfileSection section)
+        : profiler(profiler), section(section), start(profiler ? profiler->now() : 0) {}
+
+    ~ScopedTimer() {
+        if (profiler) {
+            profiler->addSample(section, start, profiler->now());
+        }
+    }
+
+    ScopedTimer(const ScopedTimer&) = delete;
+    ScopedTimer& operator=(const ScopedTimer&) = delete;
+};
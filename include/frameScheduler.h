@@ -0,0 +1,67 @@
+#pragma once
+
+#include <SDL3/SDL.h>
+#include <cstdint>
+
+/**
+ * @brief Fixed timestep simulation with a free running render rate
+ *
+ * Real elapsed time is added to an accumulator each frame and spent in
+ * whole simulation ticks of a fixed length, so gameplay runs at the same
+ * speed whatever the frame rate. Rendering happens once per loop iteration,
+ * as fast as the machine, the vsync setting or the optional frame cap allow.
+ *
+ * The frame cap sleeps for most of the remaining time and spins for the
+ * last SPIN_SECONDS, since OS sleeps routinely overshoot by a millisecond
+ * or more.
+ *
+ * Usage:
+ *     int ticks = scheduler.beginFrame();
+ *     for (int i = 0; i < ticks; i++) simulate(scheduler.getTickSeconds());
+ *     render();
+ *     scheduler.endFrame();
+ */
+class FrameScheduler {
+private:
+    static constexpr double SPIN_SECONDS = 0.002;
+
+    // Longest stretch of real time simulated in one frame, stops a long
+    // stall (window drag, breakpoint) from turning into hundreds of ticks
+    static constexpr double MAX_CATCH_UP_SECONDS = 0.25;
+
+    uint64_t frequency;
+    uint64_t frameStart;
+    bool started;
+    double tickSeconds;
+    double accumulator;
+    double frameCapSeconds;
+    double lastFrameSeconds;
+
+    double secondsSince(uint64_t counter) const {
+        return static_cast<double>(SDL_GetPerformanceCounter() - counter) / frequency;
+    }
+
+public:
+    /**
+     * @param tickRate Simulation ticks per second
+     * @param frameCap Maximum frames per second, 0 = uncapped
+     */
+    FrameScheduler(double tickRate = 60.0, double frameCap = 0.0)
+        : frequency(SDL_GetPerformanceFrequency()), frameStart(0), started(false),
+          tickSeconds(1.0 / tickRate), accumulator(0.0), frameCapSeconds(0.0), lastFrameSeconds(0.0) {
+        setFrameCap(frameCap);
+    }
+
+    void setFrameCap(double framesPerSecond);
+
+    // Starts a frame and returns how many fixed ticks to simulate in it
+    int beginFrame();
+
+    // Waits out the rest of the frame when a frame cap is set
+    void endFrame();
+
+    float getTickSeconds() const { return static_cast<float>(tickSeconds); }
+
+    // Wall time of the previous complete frame
+    double getFrameSeconds() const { return lastFrameSeconds; }
+};
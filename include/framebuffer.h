@@ -0,0 +1,79 @@
+#pragma once
+
+#include <SDL3/SDL.h>
+#include <iostream>
+#include <cstdint>
+#include <algorithm>
+
+/**
+ * @brief CPU side framebuffer backed by a streaming SDL texture
+ *
+ * Each frame the texture is locked, the CPU writes 32-bit XRGB pixels
+ * directly into the mapped memory, and the whole frame is presented with a
+ * single SDL_RenderTexture call. This replaces thousands of tiny draw calls
+ * with one texture upload.
+ *
+ * The texture belongs to the renderer it was created with, so release()
+ * must be called before that renderer is destroyed.
+ */
+class Framebuffer {
+private:
+    SDL_Texture* texture;
+    int width;
+    int height;
+
+    // Valid only between lock() and unlock()
+    uint32_t* pixels;
+    int pitch; // In pixels, not bytes
+
+public:
+    Framebuffer() : texture(nullptr), width(0), height(0), pixels(nullptr), pitch(0) {}
+
+    ~Framebuffer() {
+        release();
+    }
+
+    Framebuffer(const Framebuffer&) = delete;
+    Framebuffer& operator=(const Framebuffer&) = delete;
+
+    static uint32_t packColor(uint8_t r, uint8_t g, uint8_t b) {
+        return (static_cast<uint32_t>(r) << 16) | (static_cast<uint32_t>(g) << 8) | b;
+    }
+
+    // (Re)creates the texture if the size changed, returns false if SDL fails
+    bool resize(SDL_Renderer* renderer, int newWidth, int newHeight);
+
+    void release();
+
+    bool lock();
+
+    void unlock();
+
+    // Draws the whole texture stretched over the render target
+    void present(SDL_Renderer* renderer) {
+        SDL_RenderTexture(renderer, texture, nullptr, nullptr);
+    }
+
+    uint32_t* row(int y) { return pixels + static_cast<ptrdiff_t>(y) * pitch; }
+
+    void fillRows(int firstRow, int endRow, uint32_t color) {
+        for (int y = std::max(firstRow, 0); y < std::min(endRow, height); y++) {
+            std::fill(row(y), row(y) + width, color);
+        }
+    }
+
+    // Vertical run of one color in column x, rows [firstRow, endRow)
+    void fillColumn(int x, int firstRow, int endRow, uint32_t color) {
+        firstRow = std::max(firstRow, 0);
+        endRow = std::min(endRow, height);
+        uint32_t* pixel = row(firstRow) + x;
+        for (int y = firstRow; y < endRow; y++) {
+            *pixel = color;
+            pixel += pitch;
+        }
+    }
+
+    int getWidth() const { return width; }
+    int getHeight() const { return height; }
+    int getPitch() const { return pitch; }
+};
@@ -0,0 +1,302 @@
+#pragma once
+
+#include <vector>
+#include <math.h>
+#include <stdlib.h>
+#include <algorithm>
+
+#include "mapGrid.h"
+
+// First wall found by WorldMap::findWallOnSegment
+struct SegmentHit {
+    float x;                // Point where the segment enters the wall cell
+    float y;
+    float fraction;         // 0 at the segment start, 1 at its end
+    int wallType;           // 0 when the segment is clear
+    bool hitVerticalWall;   // An x side was crossed, as in RayHit
+};
+
+class WorldMap {
+private:
+    MapGrid grid;
+    int height;
+    int width;
+
+    // Cells changed by setCell and setCells since the last flushEdits, no two touching
+    std::vector<CellRect> dirtyRects;
+
+    // Not owned. Registered against this map only, so copies start without them
+    std::vector<MapEditListener*> editListeners;
+
+    // More separate rects than this and they are all merged into one
+    static constexpr size_t MAX_DIRTY_RECTS = 16;
+
+    // Adds rect to dirtyRects, first absorbing every rect it touches, so
+    // a door's cells or a run of broken wall end up as one region
+    void markDirty(CellRect rect);
+
+    // walkSegment results that aren't a cell index
+    static constexpr int SEGMENT_CLEAR = -1;
+    static constexpr int SEGMENT_STARTS_OUTSIDE = -2;
+
+    /**
+     * Walks the cells the segment from (ax, ay) to (bx, by) passes through,
+     * the start and end cells included, and returns the flat index of the
+     * first wall, or SEGMENT_CLEAR if there is none. fraction and crossedX describe
+     * the last side crossed.
+     *
+     * The walk makes exactly as many x and y steps as separate the two end
+     * cells, so it always stops in the end cell and needs no distance test
+     * per step. An end outside the map runs into the solid border, while a
+     * start outside it counts as inside a wall.
+     */
+    int walkSegment(float ax, float ay, float bx, float by, float& fraction, bool& crossedX) const;
+
+    // Gap left between a box and the wall face it stopped at, so it never rests exactly on a cell boundary
+    static constexpr float COLLISION_SKIN = 1.0f / 1024.0f;
+
+    // Longest move on either axis in one moveBox sub-step
+    static constexpr float MAX_SUBSTEP = 0.5f;
+
+    static int clampCell(int cell, int limit) {
+        return std::min(std::max(cell, -MapGrid::BORDER), limit);
+    }
+
+    /**
+     * Moves a box along one axis by delta. Every cell line its leading face
+     * crosses is tested across the span the box covers on the other axis,
+     * and the box stops just short of the first line holding a wall, so no
+     * move is long enough to pass through one. alongStride and
+     * acrossStride step the flat grid along and across the move, the
+     * limits are the map size on each axis (the solid border beyond).
+     *
+     * The box covers [across - halfSize, across + halfSize) so a face lying
+     * exactly on a cell boundary doesn't touch the next cell.
+     */
+    bool sweepAxis(float& along, float across, float halfSize, float delta,
+                   int alongStride, int acrossStride, int alongLimit, int acrossLimit) const;
+
+    // Replaces the cells and marks the whole map dirty, for the assignments
+    WorldMap& assignCells(MapGrid&& cells);
+    
+public:
+    WorldMap(const std::vector<std::vector<int>>& mapData, int height, int width) 
+        : grid(mapData, height, width), height(height), width(width) {
+        // Validate dimensions match mapData
+        //if (mapData.size() != height || (height > 0 && mapData[0].size() != width)) {
+        //    throw std::invalid_argument("Map dimensions don't match data");
+        //}
+    }
+
+    // Takes over a prepared grid, such as one loaded by loadMazeFile
+    explicit WorldMap(MapGrid&& mapGrid)
+        : grid(std::move(mapGrid)), height(grid.getHeight()), width(grid.getWidth()) {}
+
+    // All solid map for callers that fill the grid in themselves
+    WorldMap(int height, int width) : grid(width, height), height(height), width(width) {}
+
+    // A copy or moved-to map has the cells but none of the listeners or
+    // pending edits, which belong to the map they were made on
+    WorldMap(const WorldMap& other) : grid(other.grid), height(other.height), width(other.width) {}
+    WorldMap(WorldMap&& other) : grid(std::move(other.grid)), height(other.height), width(other.width) {}
+
+    // Assigning keeps this map's own listeners, which hear at the next
+    // flushEdits that every cell may have changed
+    WorldMap& operator=(const WorldMap& other) { return assignCells(MapGrid(other.grid)); }
+    WorldMap& operator=(WorldMap&& other) { return assignCells(std::move(other.grid)); }
+
+    // Shared flat storage, read by the raycaster, minimap and collision checks
+    const MapGrid& getGrid() const { return grid; }
+
+    // Writable cells for bulk rewrites such as ChunkedWorld's. Whoever
+    // rewrites them must tell anything that caches map contents, such as
+    // the minimap texture; setCell and setCells do that for single edits
+    MapGrid& editGrid() { return grid; }
+
+    /**
+     * @brief Changes one cell, for doors and destructible walls
+     *
+     * The cell is marked dirty and listeners hear about it at the next
+     * flushEdits. Setting a cell to the value it has is not an edit.
+     * Returns false for a cell outside the map, the border can't change.
+     */
+    bool setCell(int x, int y, uint8_t wallType) {
+        return setCells({ x, y, x + 1, y + 1 }, wallType);
+    }
+
+    // Every cell of rect, clipped to the map, as one dirty region
+    bool setCells(CellRect rect, uint8_t wallType);
+
+    /**
+     * @brief Hands the dirty rects to every listener, then clears them
+     *
+     * Edits made between flushes are merged, so listeners redo each region
+     * once however many times its cells changed. Call it from the thread
+     * that made the edits, after the tick that made them. Listeners must
+     * not edit the map from onCellsChanged.
+     */
+    void flushEdits();
+
+    // Edits waiting for flushEdits
+    const std::vector<CellRect>& getDirtyRects() const { return dirtyRects; }
+
+    // listener must outlive the map or be removed first
+    void addEditListener(MapEditListener* listener);
+
+    void removeEditListener(MapEditListener* listener);
+    
+    // Validate bounds before access
+    bool isWall(int x, int y) const { 
+        if (!grid.inBounds(x, y)) {
+            return true; // Treat out-of-bounds as walls
+        }
+        return grid.at(x, y) != 0; 
+    }
+    
+    int getWallType(int x, int y) const { 
+        if (!grid.inBounds(x, y)) {
+            return 1; // Default wall type
+        }
+        return grid.at(x, y); 
+    }
+
+    /**
+     * True when no wall lies on the segment from (ax, ay) to (bx, by),
+     * counting the cells both ends are in. Stops at the first wall and
+     * builds no ray results, so it is cheap enough for per-tick AI checks.
+     * See Raycaster::testLinesOfSight for many at once.
+     */
+    bool hasLineOfSight(float ax, float ay, float bx, float by) const;
+
+    /**
+     * Finds the first wall along the segment from (ax, ay) to (bx, by).
+     * Returns false and sets hit.wallType to 0 when the segment is clear.
+     * A start inside a wall or outside the map is a hit at fraction 0.
+     */
+    bool findWallOnSegment(float ax, float ay, float bx, float by, SegmentHit& hit) const;
+
+    /**
+     * @brief Moves an axis-aligned box by (dx, dy), sliding along walls
+     *
+     * The box is centred on (x, y) and halfSize across each way, which
+     * must be below 0.5 to fit down a corridor. The move is split into
+     * sub-steps of at most MAX_SUBSTEP per axis; each sweeps x then y, so
+     * the blocked axis stops at the wall face and the other keeps going.
+     * That gives sliding along walls and round corners, and as every cell
+     * the box sweeps over is tested, no speed can tunnel through a wall.
+     *
+     * Only float arithmetic in a fixed order, so the same inputs always
+     * give the same result, whichever thread runs it.
+     *
+     * @return true if a wall stopped the box on either axis
+     */
+    bool moveBox(float& x, float& y, float halfSize, float dx, float dy) const;
+
+    int getWidth() const { return width; }
+    int getHeight() const { return height; }
+};
+
+// Movement keys held during a tick, as a bitmask so a whole snapshot fits in one atomic
+enum PlayerInput : uint32_t {
+    INPUT_FORWARD = 1 << 0,
+    INPUT_BACKWARDS = 1 << 1,
+    INPUT_TURN_LEFT = 1 << 2,
+    INPUT_TURN_RIGHT = 1 << 3
+};
+
+class Player {
+private:
+    float x;
+    float y;
+    float angle;
+    float FOV;
+    float moveSpeed;    // Map cells per second
+    float rotateSpeed;  // Multiplier on TURN_RATE
+
+    // Unit facing vector, only recomputed when the angle changes
+    float dirX;
+    float dirY;
+    
+    // Add reference to map for collision detection
+    const WorldMap* worldMap;
+
+    void updateDirection() {
+        dirX = cos(angle);
+        dirY = sin(angle);
+    }
+
+    // Slides along walls, see WorldMap::moveBox
+    void move(float distance) {
+        if (worldMap) {
+            worldMap->moveBox(x, y, COLLISION_HALF_SIZE, dirX * distance, dirY * distance);
+        }
+    }
+
+public:
+    // Radians per second at rotateSpeed 1, the old 0.1 per frame at ~30 frames a second
+    static constexpr float TURN_RATE = 3.0f;
+
+    // Half the side of the player's collision box, in map cells
+    static constexpr float COLLISION_HALF_SIZE = 0.2f;
+
+    Player(float startX, float startY, float startAngle, float fov, float rotateSpeed = 2.0f) 
+        : x(startX), y(startY), angle(startAngle), FOV(fov), 
+          moveSpeed(6.0f), rotateSpeed(rotateSpeed), worldMap(nullptr) {
+        updateDirection();
+    }
+    
+    // Allow setting world map for collision detection
+    void setWorldMap(const WorldMap* map) { worldMap = map; }
+    
+    // Collides with walls, scaled by the simulation tick length
+    void moveForward(float deltaTime) { move(moveSpeed * deltaTime); }
+    void moveBackwards(float deltaTime) { move(-moveSpeed * deltaTime); }
+    
+    void turnLeft(float deltaTime) {
+        angle -= TURN_RATE * rotateSpeed * deltaTime;
+        updateDirection();
+    }
+
+    void turnRight(float deltaTime) {
+        angle += TURN_RATE * rotateSpeed * deltaTime;
+        updateDirection();
+    }
+
+    // One simulation tick of the PlayerInput keys in heldKeys
+    void applyInput(uint32_t heldKeys, float deltaTime) {
+        if (heldKeys & INPUT_FORWARD) {
+            moveForward(deltaTime);
+        }
+        if (heldKeys & INPUT_BACKWARDS) {
+            moveBackwards(deltaTime);
+        }
+        if (heldKeys & INPUT_TURN_LEFT) {
+            turnLeft(deltaTime);
+        }
+        if (heldKeys & INPUT_TURN_RIGHT) {
+            turnRight(deltaTime);
+        }
+    }
+    
+    // Const getters
+    float getX() const { return x; }
+    float getY() const { return y; }
+    float getAngle() const { return angle; }
+    float getFieldOfView() const { return FOV; }
+    float getDirX() const { return dirX; }
+    float getDirY() const { return dirY; }
+    
+    // Validated setters
+    void setPosition(float nx, float ny) { 
+        if (worldMap && worldMap->isWall(static_cast<int>(nx), static_cast<int>(ny))) {
+            return; // Don't allow moving into walls
+        }
+        x = nx; 
+        y = ny; 
+    }
+    
+    void setAngle(float nAngle) {
+        angle = nAngle;
+        updateDirection();
+    }
+};
\ No newline at end of file
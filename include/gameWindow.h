@@ -0,0 +1,242 @@
+#pragma once
+
+#include <SDL3/SDL.h>
+#include <iostream>
+#include <vector>
+
+#include "game.h"
+#include "raycaster.h"
+#include "framebuffer.h"
+#include "frameProfiler.h"
+#include "wallTextures.h"
+#include "floorCaster.h"
+#include "spriteRenderer.h"
+#include "resolutionController.h"
+#include "mapWindow.h"
+#include <cstdio>
+
+struct Color {
+    unsigned char r;
+    unsigned char g;
+    unsigned char b;
+    unsigned char a;
+    
+    // Constructor with default alpha = 255 (fully opaque)
+    Color(unsigned char red = 0, unsigned char green = 0, unsigned char blue = 0, unsigned char alpha = 255)
+        : r(red), g(green), b(blue), a(alpha) {}
+};
+
+// How GameView gets pixels on screen
+enum class RenderMode {
+    DRAW_CALLS,     // One SDL_RenderFillRect per column
+    FRAMEBUFFER     // Columns written on the CPU, one texture upload per frame
+};
+
+//Not finished at all
+class GameView {
+private:
+    RenderMode renderMode;
+    Framebuffer framebuffer;
+
+    // Used by the framebuffer path, draw calls stay flat shaded
+    WallTextureAtlas wallTextures;
+    FloorCaster floorCaster;
+    bool texturedWalls;
+    bool texturedFloors;
+
+    // Billboards drawn over the walls in framebuffer mode, clipped by columnDepths
+    SpriteTextureAtlas spriteTextures;
+    SpriteRenderer spriteRenderer;
+    const SpritePool* sprites;
+    std::vector<float> columnDepths;
+
+    // On-screen height of a wall one cell away, set for the target being drawn
+    float projectionScale;
+
+    // The floor is drawn as one flat backdrop behind the walls, top and bottom alike
+    const Color ceilingColor = Color(0, 0, 100, 255);
+    const Color floorColor = Color(0, 0, 100, 255);
+
+    Color getWallColor(int wallType) const {
+        switch(wallType) {
+            case 1:
+                return Color(255, 0, 0, 255);
+            case 2:
+                return Color(255, 255, 0, 255);
+        }
+        return Color(100, 100, 100, 255);
+    }
+
+    /**
+     * Focal length of the camera plane in pixels: a wall one cell away
+     * spans this many rows. Taken from the horizontal FOV so walls keep
+     * square proportions whatever the window size.
+     */
+    static float focalLengthFor(float fieldOfView, float viewWidth) {
+        float FOVRadians = fieldOfView * (M_PI / 180.0f);
+        return (viewWidth / 2.0f) / tan(FOVRadians / 2.0f);
+    }
+
+    // Height of the whole wall slice on screen, which may run past the top and bottom
+    float getProjectedHeight(const RayHit& ray, float screenHeight) const {
+        return (ray.distance > 0.01f) ? (projectionScale / ray.distance) : screenHeight;
+    }
+
+    float getWallHeight(const RayHit& ray, float screenHeight) const {
+        float wallHeight = getProjectedHeight(ray, screenHeight);
+
+        // Cap the wall height to screen height
+        if (wallHeight > screenHeight) wallHeight = screenHeight;
+        return wallHeight;
+    }
+
+    // One rect per ray, each rayWidth window pixels wide
+    void drawRays(SDL_Renderer* renderer, float rayWidth, const std::vector<RayHit>& rayResults, float screenHeight);
+
+    void drawFloor(SDL_Renderer* renderer, float windowHeight, float windowWidth);
+
+    // Framebuffer version of drawFloor + drawRays
+    void drawFrame(const Player& player, const std::vector<RayHit>& rayResults, int screenHeight, int screenWidth);
+
+    void drawTexturedColumn(int x, const RayHit& ray, int screenHeight);
+
+    bool renderFramebuffer(SDL_Renderer* renderer, const Player& player, const std::vector<RayHit>& rayResults,
+                           float screenHeight, float screenWidth);
+
+public:
+    GameView()
+        : renderMode(RenderMode::FRAMEBUFFER), floorCaster(wallTextures), texturedWalls(true),
+          texturedFloors(true), spriteRenderer(spriteTextures), sprites(nullptr), projectionScale(1.0f) {}
+
+    void setRenderMode(RenderMode mode) { renderMode = mode; }
+    RenderMode getRenderMode() const { return renderMode; }
+
+    // Textured or flat colored walls in framebuffer mode
+    void setTexturedWalls(bool enabled) { texturedWalls = enabled; }
+
+    // Cast floor and ceiling or a flat backdrop in framebuffer mode
+    void setTexturedFloors(bool enabled) { texturedFloors = enabled; }
+
+    // Sprites drawn in framebuffer mode, nullptr for none. Read while drawing, so not moved meanwhile
+    void setSprites(const SpritePool* pool) { sprites = pool; }
+
+    // Pool the floor caster and sprites spread work over, nullptr draws on the render thread
+    void setThreadPool(ThreadPool* pool) {
+        floorCaster.setThreadPool(pool);
+        spriteRenderer.setThreadPool(pool);
+    }
+
+    // Frees renderer owned resources, call before the renderer is destroyed
+    void releaseResources() {
+        framebuffer.release();
+    }
+
+    /**
+     * Draws one ray result per column. In framebuffer mode the frame is
+     * rendered at rayResults.size() x (screenHeight / rowHeight) pixels and
+     * stretched over the window; draw calls make each ray rayWidth pixels wide.
+     */
+    void render(SDL_Renderer* renderer, const Player& player, float rayWidth, int rowHeight,
+                const std::vector<RayHit>& rayResults, float screenHeight, float screenWidth);
+}; 
+
+
+class GameWindow {
+private:
+    SDL_Window* window;
+    SDL_Renderer* renderer;
+    GameView gameView;
+    Minimap* minimap;
+    int windowWidth;
+    int windowHeight;
+    int FOV;
+    float rayWidth;     // Window pixels per ray column
+    int rowHeight;      // Window rows per framebuffer row
+
+    FrameProfiler* profiler;
+    bool showProfilerOverlay;
+    bool overlayKeyWasDown;
+
+    // Timing table drawn over the frame with SDL's built-in debug font
+    void drawProfilerOverlay();
+
+    // Picture-in-picture in the top right corner, a third of the window high
+    void drawMinimapOverlay(const Player& player, const std::vector<RayHit>& rayResults);
+
+    void cleanup();
+
+    // Movement is returned as PlayerInput bits, quitting is up to DisplayManager
+    uint32_t readKeys();
+
+public:
+    GameWindow(int width = 1280, int height = 720, int fov = 120)
+        : window(nullptr), renderer(nullptr), minimap(nullptr), windowWidth(width), windowHeight(height), FOV(fov), rayWidth(1.0f), rowHeight(1),
+          profiler(nullptr), showProfilerOverlay(true), overlayKeyWasDown(false) {}
+
+    ~GameWindow() {
+        cleanup();
+    }
+
+    SDL_WindowID getWindowID() const {
+        return window ? SDL_GetWindowID(window) : 0;
+    }
+
+    void setRenderMode(RenderMode mode) {
+        gameView.setRenderMode(mode);
+    }
+
+    void setTexturedWalls(bool enabled) {
+        gameView.setTexturedWalls(enabled);
+    }
+
+    void setTexturedFloors(bool enabled) {
+        gameView.setTexturedFloors(enabled);
+    }
+
+    // Billboards drawn over the walls in framebuffer mode, must outlive this window or be unset first
+    void setSprites(const SpritePool* sprites) {
+        gameView.setSprites(sprites);
+    }
+
+    // Internal resolution picked by a ResolutionController, frames are stretched to the window
+    void setResolution(int columnWidth, int rows) {
+        rayWidth = static_cast<float>(std::max(columnWidth, 1));
+        rowHeight = std::max(rows, 1);
+    }
+
+    // Can be the raycaster's pool unless casting runs on a FramePipeline thread
+    void setThreadPool(ThreadPool* pool) {
+        gameView.setThreadPool(pool);
+    }
+
+    // Times rendering and present, and draws the stats overlay. nullptr turns it off
+    void setProfiler(FrameProfiler* frameProfiler) {
+        profiler = frameProfiler;
+    }
+
+    // Call after DisplayManager::init, window and renderer are created here
+    bool init();
+
+    // Minimap drawn as an overlay over every frame, nullptr for none. Must outlive this window or be unset first
+    void setMinimap(Minimap* map);
+
+    void initRun() {
+        rayWidth = 1.0f;
+        rowHeight = 1;
+    }
+
+    /**
+     * Reads the keyboard without touching a player, for a simulation
+     * running on another thread. Call from the thread that pumps SDL
+     * events, after DisplayManager::pumpEvents.
+     */
+    uint32_t pollInput() {
+        return readKeys();
+    }
+
+    // Draws and presents one frame, how often is up to the caller's frame scheduler
+    void update(const Player& player, const std::vector<RayHit>& rayResults);
+
+    // Let the present wait for the display refresh instead of running uncapped
+    void setVSync(bool enabled);
+};
\ No newline at end of file
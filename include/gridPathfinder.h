@@ -0,0 +1,144 @@
+#pragma once
+
+#include "game.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <math.h>
+#include <vector>
+
+enum class PathAlgorithm {
+    A_STAR,
+    JUMP_POINT      // Same paths as A_STAR, far fewer nodes on open maps
+};
+
+/**
+ * @brief Shortest paths between two cells of a WorldMap
+ *
+ * Moves go to any of the 8 neighbours, straight moves cost 1 and diagonal
+ * ones sqrt(2). A diagonal move needs both cells it passes between to be
+ * open, so paths never cut a wall corner and a Player sized box can
+ * follow them. The octile distance is the heuristic, so both algorithms
+ * return optimal paths.
+ *
+ * Everything runs on flat MapGrid indices. The solid border means
+ * neighbours never need bounds checks. Per-cell scores are stamped with a
+ * search number instead of being cleared, and the open list is a binary
+ * heap in a reused vector, so repeated queries don't allocate once the
+ * buffers have grown.
+ *
+ * One query at a time per pathfinder; use one per thread for parallel
+ * queries. For many agents heading to the same target a FlowField is
+ * cheaper than a path each.
+ */
+class GridPathfinder {
+public:
+    static constexpr float DIAGONAL_COST = 1.41421356f;
+
+private:
+    struct OpenNode {
+        float estimate;     // Cost so far plus heuristic
+        float cost;         // Cost so far, larger wins ties so the search dives toward the goal
+        int32_t cell;
+
+        bool operator<(const OpenNode& other) const {
+            if (estimate != other.estimate) {
+                return estimate > other.estimate;
+            }
+            return cost < other.cost;
+        }
+    };
+
+    const WorldMap& worldMap;
+    const uint8_t* cells;
+    int stride;
+
+    std::vector<float> costs;
+    std::vector<int32_t> parents;
+    std::vector<uint32_t> seenSearch;       // costs and parents are valid when this is the current search
+    std::vector<uint32_t> closedSearch;
+    std::vector<OpenNode> openList;
+    uint32_t search;
+
+    int goalCell;
+    int goalX;
+    int goalY;
+    int lastExpanded;
+    float lastCost;
+
+    bool isOpen(int cell) const { return cells[cell] == 0; }
+
+    int cellX(int cell) const { return cell % stride - MapGrid::BORDER; }
+    int cellY(int cell) const { return cell / stride - MapGrid::BORDER; }
+
+    static float octile(int dx, int dy) {
+        dx = abs(dx);
+        dy = abs(dy);
+        return std::max(dx, dy) + (DIAGONAL_COST - 1.0f) * std::min(dx, dy);
+    }
+
+    float distanceBetween(int from, int to) const {
+        return octile(cellX(to) - cellX(from), cellY(to) - cellY(from));
+    }
+
+    // Sizes the buffers for the current grid and starts a new search number
+    void beginSearch(int goal);
+
+    void pushNode(int cell, float cost, int parent);
+
+    // Next cell to expand, -1 once the open list is empty
+    int popNode();
+
+    // A diagonal step from cell needs both cells it squeezes between open
+    bool canStep(int cell, int dx, int dy) const {
+        if (!isOpen(cell + dx + dy * stride)) {
+            return false;
+        }
+        return dx == 0 || dy == 0 || (isOpen(cell + dx) && isOpen(cell + dy * stride));
+    }
+
+    void expandNeighbours(int cell);
+
+    /**
+     * Walks from cell in direction (dx, dy) until it reaches the goal or a
+     * jump point, a cell with a neighbour that can't be reached as cheaply
+     * without passing through it. Returns -1 if the walk runs into a wall.
+     * A diagonal walk stops where a straight walk along either of its axes
+     * would find a jump point. These are the rules for grids without
+     * corner cutting.
+     */
+    int jump(int cell, int dx, int dy) const;
+
+    void pushJump(int cell, int dx, int dy);
+
+    // Only the directions the parent's move leaves worth searching
+    void expandJumpPoints(int cell);
+
+    // Every cell from start to goal, filling in the straight runs between jump points
+    void buildPath(std::vector<int>& path) const;
+
+public:
+    explicit GridPathfinder(const WorldMap& map)
+        : worldMap(map), cells(nullptr), stride(0), search(0), goalCell(-1), goalX(0), goalY(0),
+          lastExpanded(0), lastCost(0.0f) {}
+
+    /**
+     * @brief Finds a shortest path from cell (startX, startY) to (endX, endY)
+     *
+     * path receives the flat MapGrid index of every cell on the way, both
+     * ends included (see getCellX/getCellY). Returns false and leaves path
+     * empty when either end is a wall or outside the map, or no path exists.
+     */
+    bool findPath(int startX, int startY, int endX, int endY, std::vector<int>& path,
+                  PathAlgorithm algorithm = PathAlgorithm::A_STAR);
+
+    // Map cell of a path entry
+    int getCellX(int cell) const { return cellX(cell); }
+    int getCellY(int cell) const { return cellY(cell); }
+
+    // Length of the last path found, in cells
+    float getLastCost() const { return lastCost; }
+
+    // Nodes taken off the open list by the last query
+    int getLastExpanded() const { return lastExpanded; }
+};
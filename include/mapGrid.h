@@ -0,0 +1,178 @@
+#pragma once
+
+#include <vector>
+#include <memory>
+#include <cstdint>
+#include <cstddef>
+#include <algorithm>
+
+/**
+ * @brief Contiguous row-major storage for the maze cells
+ *
+ * Cells are stored as uint8_t wall IDs (0 = empty) in one flat buffer.
+ * The map is surrounded by a one cell border of solid walls, so any walk
+ * that starts inside the map and moves one cell at a time is guaranteed
+ * to hit a wall before it can leave the buffer. This lets the raycaster DDA
+ * run without a bounds check per step.
+ *
+ * Each row is padded out to a multiple of ROW_ALIGNMENT cells so rows
+ * start on predictable boundaries, and the buffer carries TAIL_PADDING
+ * spare bytes so 32-bit gathers of the last cell stay in bounds.
+ *
+ * The cells normally live in the grid's own buffer, but a grid can also
+ * adopt external storage in exactly this layout, such as a memory-mapped
+ * maze file (see loadMazeFile), so loading needs no parsing or copying.
+ */
+class MapGrid {
+public:
+    static constexpr int BORDER = 1;
+    static constexpr int ROW_ALIGNMENT = 16;
+    static constexpr int TAIL_PADDING = 4;
+    static constexpr uint8_t BORDER_WALL = 1;
+
+private:
+    std::vector<uint8_t> cells;
+
+    // Keeps adopted storage alive, empty when the grid owns its cells
+    std::shared_ptr<void> storage;
+
+    // Start of the cell buffer, cells.data() or the adopted storage
+    uint8_t* base;
+    size_t byteSize;
+
+    int width;
+    int height;
+    int stride;
+
+public:
+    MapGrid() : base(nullptr), byteSize(0), width(0), height(0), stride(0) {}
+
+    // Row stride used for a map this wide
+    static int strideFor(int width) {
+        int paddedWidth = width + 2 * BORDER;
+        return (paddedWidth + ROW_ALIGNMENT - 1) / ROW_ALIGNMENT * ROW_ALIGNMENT;
+    }
+
+    // Bytes of storage for a map of this size, border and tail padding included
+    static size_t byteSizeFor(int stride, int height) {
+        return static_cast<size_t>(stride) * (height + 2 * BORDER) + TAIL_PADDING;
+    }
+
+    // All solid map, filled in afterwards through row()
+    MapGrid(int width, int height) : width(width), height(height) {
+        stride = strideFor(width);
+
+        // Everything starts solid, so the border and row padding are walls
+        cells.assign(byteSizeFor(stride, height), BORDER_WALL);
+        base = cells.data();
+        byteSize = cells.size();
+    }
+
+    /**
+     * @brief Use external storage already in grid layout
+     *
+     * The caller guarantees the buffer is at least byteSizeFor(stride,
+     * height) bytes and that the border ring is solid. storage is held
+     * until the grid is destroyed, its deleter releases the buffer.
+     */
+    MapGrid(std::shared_ptr<void> storage, uint8_t* data, size_t size, int width, int height, int stride)
+        : storage(std::move(storage)), base(data), byteSize(size), width(width), height(height), stride(stride) {}
+
+    // Copies always own their cells, even when copied from adopted storage
+    MapGrid(const MapGrid& other)
+        : cells(other.base, other.base + other.byteSize), base(cells.data()), byteSize(other.byteSize),
+          width(other.width), height(other.height), stride(other.stride) {}
+
+    MapGrid(MapGrid&& other) noexcept
+        : cells(std::move(other.cells)), storage(std::move(other.storage)), base(other.base),
+          byteSize(other.byteSize), width(other.width), height(other.height), stride(other.stride) {
+        other.base = nullptr;
+        other.byteSize = 0;
+        other.width = other.height = other.stride = 0;
+    }
+
+    MapGrid& operator=(MapGrid other) noexcept {
+        std::swap(cells, other.cells);
+        std::swap(storage, other.storage);
+        std::swap(base, other.base);
+        std::swap(byteSize, other.byteSize);
+        std::swap(width, other.width);
+        std::swap(height, other.height);
+        std::swap(stride, other.stride);
+        return *this;
+    }
+
+    MapGrid(const std::vector<std::vector<int>>& mapData, int height, int width)
+        : MapGrid(width, height) {
+        for (int y = 0; y < height && y < (int)mapData.size(); y++) {
+            const std::vector<int>& row = mapData[y];
+            uint8_t* out = base + index(0, y);
+            for (int x = 0; x < width; x++) {
+                out[x] = (x < (int)row.size()) ? static_cast<uint8_t>(row[x]) : BORDER_WALL;
+            }
+        }
+    }
+
+    // Flat index of map cell (x, y). Valid for -BORDER <= x < width + BORDER
+    int index(int x, int y) const { return (y + BORDER) * stride + (x + BORDER); }
+
+    bool inBounds(int x, int y) const { return x >= 0 && x < width && y >= 0 && y < height; }
+
+    // Unchecked access, valid anywhere inside the border
+    uint8_t at(int x, int y) const { return base[index(x, y)]; }
+
+    const uint8_t* data() const { return base; }
+
+    // Whole buffer including border, row and tail padding
+    size_t getByteSize() const { return byteSize; }
+
+    // First cell of map row y, width cells follow contiguously
+    uint8_t* row(int y) { return base + index(0, y); }
+
+    int getWidth() const { return width; }
+    int getHeight() const { return height; }
+    int getStride() const { return stride; }
+    bool empty() const { return width == 0 || height == 0; }
+};
+
+// Map cells [x0, x1) x [y0, y1), empty when either range is
+struct CellRect {
+    int x0;
+    int y0;
+    int x1;
+    int y1;
+
+    bool empty() const { return x0 >= x1 || y0 >= y1; }
+
+    // Smallest rect holding both, an empty rect adds nothing
+    CellRect merged(const CellRect& other) const {
+        if (empty()) {
+            return other;
+        }
+        if (other.empty()) {
+            return *this;
+        }
+        return { std::min(x0, other.x0), std::min(y0, other.y0), std::max(x1, other.x1), std::max(y1, other.y1) };
+    }
+
+    // Whether the rects overlap or share an edge or corner
+    bool touches(const CellRect& other) const {
+        return x0 <= other.x1 && other.x0 <= x1 && y0 <= other.y1 && other.y0 <= y1;
+    }
+
+    int area() const { return empty() ? 0 : (x1 - x0) * (y1 - y0); }
+};
+
+/**
+ * @brief Something that keeps data derived from map cells up to date
+ *
+ * Registered with WorldMap::addEditListener. WorldMap::flushEdits calls
+ * onCellsChanged once per dirty rect, after the cells in it already hold
+ * their new values, so a listener only has to redo that region.
+ */
+class MapEditListener {
+public:
+    virtual ~MapEditListener() {}
+
+    virtual void onCellsChanged(const MapGrid& grid, const CellRect& cells) = 0;
+};
@@ -0,0 +1,250 @@
+#pragma once
+
+#include <SDL3/SDL.h>
+#include <iostream>
+#include <vector>
+#include <cstdint>
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+
+#include "raycaster.h"
+#include "game.h"
+#include "frameProfiler.h"
+
+
+class PlayerView {
+private:
+    // Drawn with pixelsPerCell map scale, map cell (0, 0) at origin
+    void drawPlayer(SDL_Renderer* renderer, const Player& player, SDL_FPoint origin, float pixelsPerCell) {
+        SDL_SetRenderDrawColor(renderer, 255, 0, 0, 255);
+
+        float playerPX = origin.x + player.getX() * pixelsPerCell;
+        float playerPY = origin.y + player.getY() * pixelsPerCell;
+
+        float size = std::max(pixelsPerCell / 3.0f, 1.0f);
+        SDL_FRect rect = { playerPX, playerPY, size, size };
+        SDL_RenderFillRect(renderer, &rect);
+    }
+
+    // Ray segments for the current frame, kept between frames so it never reallocates
+    std::vector<SDL_FPoint> rayPoints;
+
+    void drawRays(SDL_Renderer* renderer, const Player& player, const std::vector<RayHit>& rayResults,
+                  SDL_FPoint origin, float pixelsPerCell);
+public:
+    void render(SDL_Renderer* renderer, const Player& player, const std::vector<RayHit>& rayResults,
+                SDL_FPoint origin, float pixelsPerCell) {
+        drawPlayer(renderer, player, origin, pixelsPerCell);
+        drawRays(renderer, player, rayResults, origin, pixelsPerCell);
+    }
+}; 
+
+class Grid {
+private:
+    int squareSize;
+    int borderSize;
+    int cellSize;
+    int width;
+    int height;
+
+    // The cells being drawn. Only the rendering thread touches them, they
+    // change when render takes in what copyMap and queueEdit left pending
+    MapGrid cells;
+
+    // Size of the last copyMap, so the size getters don't need the cells
+    std::atomic<int> mapWidth;
+    std::atomic<int> mapHeight;
+
+    // The maze drawn once into a texture, blitted every frame until the map changes.
+    // A texture belongs to one renderer, so drawing with another rebuilds it.
+    SDL_Texture* mazeTexture;
+    SDL_Renderer* mazeRenderer;
+    bool mazeTextureDirty;
+    std::vector<uint32_t> mazePixels;
+    int textureWidth;
+    int textureHeight;
+
+    // Gaps between cells stay transparent so the window background shows through
+    static constexpr uint32_t WALL_PIXEL = 0xFFFFFFFF;     // White for walls
+    static constexpr uint32_t EMPTY_PIXEL = 0xFF000000;    // Black for empty
+
+    /**
+     * A whole map from copyMap and cell edits from queueEdit, waiting for
+     * render. Both are copied when they are handed over, because the
+     * thread that edits the map may already be changing it again while
+     * this one draws. pendingCells holds every rect's cells row by row,
+     * one rect after another, all made after pendingMap if there is one.
+     */
+    std::mutex pendingMutex;
+    MapGrid pendingMap;
+    bool hasPendingMap;
+    std::vector<CellRect> pendingRects;
+    std::vector<uint8_t> pendingCells;
+    std::atomic<bool> hasPendingEdits;
+
+    void paintCell(int mapX, int mapY, bool wall) {
+        uint32_t pixel = wall ? WALL_PIXEL : EMPTY_PIXEL;
+        for (int y = 0; y < squareSize; y++) {
+            uint32_t* out = &mazePixels[static_cast<size_t>(mapY * cellSize + y) * textureWidth + mapX * cellSize];
+            std::fill(out, out + squareSize, pixel);
+        }
+    }
+
+    bool textureIsCurrent(SDL_Renderer* renderer) const {
+        return !mazeTextureDirty && mazeTexture && mazeRenderer == renderer;
+    }
+
+    bool rebuildMazeTexture(SDL_Renderer* renderer);
+
+    /**
+     * Takes the pending map and edits into cells. Edits are painted into
+     * the texture and just the texels they cover uploaded, as long as the
+     * texture is current for renderer, otherwise the next rebuild has them.
+     */
+    void applyPendingEdits(SDL_Renderer* renderer);
+
+    // Fallback when the cached texture can't be created, one rect per cell
+    void drawCells(SDL_Renderer* renderer, const SDL_FRect& area);
+
+public:
+    Grid(int squareSize = 8, int borderSize = 1, int width = 566, int height = 566)
+        : squareSize(squareSize), borderSize(borderSize), width(width), height(height), mapWidth(0), mapHeight(0),
+          mazeTexture(nullptr), mazeRenderer(nullptr), mazeTextureDirty(true), textureWidth(0), textureHeight(0),
+          hasPendingMap(false), hasPendingEdits(false) {
+        cellSize = squareSize + borderSize;
+    }
+
+    ~Grid() {
+        releaseResources();
+    }
+
+    /**
+     * @brief Redraw the whole maze from a copy of mapGrid on the next render
+     *
+     * Call it from the thread that edits the map: once it is built, and
+     * again after bulk rewrites such as ChunkedWorld's that setCell
+     * doesn't report. Edits queued before it are already in the copy.
+     */
+    void copyMap(const MapGrid& mapGrid);
+
+    /**
+     * @brief Repaint only cells in rect on the next render
+     *
+     * Copies the cells now, so it may be called from the thread editing
+     * the map while another renders. A rect that doesn't fit the map last
+     * given to copyMap is dropped.
+     */
+    void queueEdit(const MapGrid& mapGrid, const CellRect& rect);
+
+    // Frees renderer owned resources, call before the renderer is destroyed
+    void releaseResources();
+
+    // Pixels per map cell at native size, gaps included
+    int getCellSize() const { return cellSize; }
+
+    // Native size of the drawn maze
+    int getPixelWidth() const {
+        int cellsWide = mapWidth.load(std::memory_order_relaxed);
+        return cellsWide > 0 ? cellsWide * cellSize - borderSize : 0;
+    }
+
+    int getPixelHeight() const {
+        int cellsHigh = mapHeight.load(std::memory_order_relaxed);
+        return cellsHigh > 0 ? cellsHigh * cellSize - borderSize : 0;
+    }
+
+    // Draws the maze stretched over area, which should keep the getPixelWidth/Height aspect
+    void render(SDL_Renderer* renderer, const SDL_FRect& area);
+};
+
+/**
+ * @brief Top-down maze with the player and this frame's rays
+ *
+ * Draws into any renderer at any size, either filling MapWindow's own
+ * window or as a picture-in-picture overlay over the game frame (see
+ * GameWindow::setMinimap). The cached maze texture follows whichever
+ * renderer draws it. It draws its own copy of the map, never the live
+ * one. Registered with WorldMap::addEditListener, setCell edits repaint
+ * only the cells they touched.
+ */
+class Minimap : public MapEditListener {
+private:
+    Grid grid;
+    PlayerView playerView;
+    FrameProfiler* profiler;
+
+public:
+    Minimap() : profiler(nullptr) {}
+
+    // Draw a copy of mapGrid, see Grid::copyMap for when and where to call it
+    void copyMap(const MapGrid& mapGrid) { grid.copyMap(mapGrid); }
+
+    // Repaints just the edited cells, safe to get from the thread that flushes the map's edits
+    void onCellsChanged(const MapGrid& mapGrid, const CellRect& cells) override { grid.queueEdit(mapGrid, cells); }
+
+    // Frees renderer owned resources, call before the renderer is destroyed
+    void releaseResources() { grid.releaseResources(); }
+
+    // Times the grid and the player view. nullptr turns it off
+    void setProfiler(FrameProfiler* frameProfiler) { profiler = frameProfiler; }
+
+    // Size at one native cell per Grid cellSize pixels
+    int getPixelWidth() const { return grid.getPixelWidth(); }
+    int getPixelHeight() const { return grid.getPixelHeight(); }
+
+    void render(SDL_Renderer* renderer, const Player& player, const std::vector<RayHit>& rayResults,
+                const SDL_FRect& area);
+};
+
+/**
+ * @brief The minimap in a second window of its own
+ *
+ * Optional, by default the minimap is an overlay in the game window. SDL
+ * itself and events belong to DisplayManager; closing this window only
+ * closes the minimap.
+ */
+class MapWindow {
+private:
+    SDL_Window* window;
+    SDL_Renderer* renderer;
+    Minimap* minimap;
+    int windowWidth;
+    int windowHeight;
+    FrameProfiler* profiler;
+
+public:
+    MapWindow(int width = 566, int height = 566)
+        : window(nullptr), renderer(nullptr), minimap(nullptr),
+          windowWidth(width), windowHeight(height), profiler(nullptr) {}
+
+    ~MapWindow() {
+        close();
+    }
+
+    // Open until close() or its close button
+    bool isOpen() const {
+        return window != nullptr;
+    }
+
+    SDL_WindowID getWindowID() const {
+        return window ? SDL_GetWindowID(window) : 0;
+    }
+
+    // Times present. nullptr turns it off
+    void setProfiler(FrameProfiler* frameProfiler) {
+        profiler = frameProfiler;
+    }
+
+    // Call after DisplayManager::init, window and renderer are created here
+    bool init();
+
+    // The minimap drawn into this window, must outlive it or be unset first
+    void initRun(Minimap* map) {
+        minimap = map;
+    }
+
+    void close();
+
+    void update(const Player& player, const std::vector<RayHit>& rayResults);
+};
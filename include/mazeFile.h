@@ -0,0 +1,100 @@
+#pragma once
+
+#include <vector>
+#include <string>
+#include <cstdint>
+
+class MapGrid;
+
+/**
+ * @brief Binary maze files
+ *
+ * A file is a fixed MazeFileHeader followed, at payloadOffset, by the grid
+ * in one of two encodings:
+ *
+ * - GRID_BYTES: one byte per cell in exactly the MapGrid layout, border,
+ *   row padding and tail padding included. loadMazeFile maps this straight
+ *   into a MapGrid, so loading costs no parsing and no copy, and pages are
+ *   only read from disk when the raycaster first touches them.
+ * - BITS: one bit per cell (1 = wall type 1), row-major, in little-endian
+ *   64-bit words, the same as BitPackedDepthFirstMazeGenerator. About 8x
+ *   smaller, but it is expanded into an owned grid on load and wall types
+ *   above 1 are stored as 1.
+ *
+ * Fields are in the writer's byte order, checked on load through
+ * byteOrderMark. The checksum is FNV-1a 64 of the payload, 0 when the
+ * file was written without one.
+ */
+
+// Generator recorded in the header, informational only
+enum class MazeFileGenerator : uint8_t {
+    UNKNOWN = 0,
+    DEPTH_FIRST = 1,
+    RECURSIVE_DIVISION = 2,
+    BIT_PACKED_DEPTH_FIRST = 3,
+    TILED = 4
+};
+
+enum class MazeFileEncoding : uint8_t {
+    GRID_BYTES = 0,
+    BITS = 1
+};
+
+struct MazeFileHeader {
+    static constexpr uint32_t MAGIC = 0x5A4D4352;       ///< "RCMZ" in little endian
+    static constexpr uint32_t BYTE_ORDER_MARK = 0x01020304;
+    static constexpr uint16_t VERSION = 1;
+    static constexpr uint32_t PAYLOAD_ALIGNMENT = 64;   ///< Payload starts on a cache line
+
+    uint32_t magic;
+    uint32_t byteOrderMark;
+    uint16_t version;
+    uint16_t headerSize;    ///< sizeof(MazeFileHeader) when written
+    uint8_t generator;      ///< MazeFileGenerator
+    uint8_t encoding;       ///< MazeFileEncoding
+    uint16_t reserved;
+    uint32_t width;
+    uint32_t height;
+    uint32_t stride;        ///< GRID_BYTES row stride in bytes, 0 for BITS
+    uint32_t reserved2;
+    uint64_t seed;          ///< 0 when the maze was seeded from the clock
+    uint64_t payloadOffset;
+    uint64_t payloadSize;
+    uint64_t checksum;
+};
+
+/**
+ * @brief FNV-1a 64 of a byte range, the checksum used in maze files
+ */
+uint64_t mazeFileChecksum(const uint8_t* data, size_t size);
+
+/**
+ * @brief Write a maze in the nested vector format used by the generators
+ *
+ * @return false if the file could not be written, the reason goes to std::cerr
+ */
+bool writeMazeFile(const std::string& path, const std::vector<std::vector<int>>& maze,
+                   MazeFileGenerator generator, uint64_t seed,
+                   MazeFileEncoding encoding = MazeFileEncoding::GRID_BYTES, bool withChecksum = true);
+
+/**
+ * @brief Write a maze that is already bit-packed, width * height bits row-major
+ */
+bool writePackedMazeFile(const std::string& path, const std::vector<uint64_t>& wallBits, int width, int height,
+                         MazeFileGenerator generator, uint64_t seed, bool withChecksum = true);
+
+/**
+ * @brief Load a maze file into a grid
+ *
+ * GRID_BYTES files are memory-mapped copy-on-write: the grid reads the
+ * file's pages directly and edits stay private to the process. The header
+ * and the solid border ring are always validated, since the raycaster
+ * relies on the border to stop; the payload checksum only when asked,
+ * because it reads the whole file. Maps whose grid buffer would pass
+ * INT_MAX bytes are refused, cells are indexed with int.
+ *
+ * @param header Receives the file header when not null
+ * @return false on any error, the reason goes to std::cerr and grid is left unchanged
+ */
+bool loadMazeFile(const std::string& path, MapGrid& grid, MazeFileHeader* header = nullptr,
+                  bool verifyChecksum = false);
@@ -0,0 +1,79 @@
+#pragma once
+
+#include "game.h"
+#include "threadPool.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <math.h>
+#include <vector>
+
+/**
+ * Entities moved by MovementSystem, in structure-of-arrays form so a
+ * batch update streams through each field. Entry i of every vector is
+ * entity i. Set speed and turnRate each tick from whatever drives the
+ * entity; position, angle and the cached facing vector are updated by
+ * MovementSystem::update.
+ */
+class MovementBatch {
+public:
+    std::vector<float> x;
+    std::vector<float> y;
+    std::vector<float> angle;       // Radians, as Player::getAngle
+    std::vector<float> dirX;        // Unit facing vector, follows angle
+    std::vector<float> dirY;
+    std::vector<float> speed;       // Cells per second along the facing vector, negative backs up
+    std::vector<float> turnRate;    // Radians per second
+    std::vector<float> halfSize;    // Collision box, see WorldMap::moveBox
+    std::vector<uint8_t> blocked;   // A wall stopped the entity in the last update
+
+    // Returns the new entity's index, standing still
+    int add(float startX, float startY, float startAngle, float boxHalfSize = Player::COLLISION_HALF_SIZE) {
+        x.push_back(startX);
+        y.push_back(startY);
+        angle.push_back(startAngle);
+        dirX.push_back(cos(startAngle));
+        dirY.push_back(sin(startAngle));
+        speed.push_back(0.0f);
+        turnRate.push_back(0.0f);
+        halfSize.push_back(boxHalfSize);
+        blocked.push_back(0);
+        return static_cast<int>(x.size()) - 1;
+    }
+
+    void setAngle(int entity, float newAngle) {
+        angle[entity] = newAngle;
+        dirX[entity] = cos(newAngle);
+        dirY[entity] = sin(newAngle);
+    }
+
+    int size() const { return static_cast<int>(x.size()); }
+};
+
+/**
+ * @brief Moves many entities a tick at a time with the player's collision rules
+ *
+ * Each entity turns by turnRate, then moves its collision box along its
+ * facing vector with WorldMap::moveBox, sliding along walls. Entities
+ * don't collide with each other, so they are independent: the batch is
+ * split over the thread pool in blocks of ENTITIES_PER_TASK and the result
+ * is the same for any thread count, which keeps a fixed-timestep
+ * simulation deterministic.
+ */
+class MovementSystem {
+public:
+    static constexpr int ENTITIES_PER_TASK = 256;
+
+private:
+    const WorldMap& worldMap;
+    ThreadPool* threadPool;
+
+public:
+    explicit MovementSystem(const WorldMap& map) : worldMap(map), threadPool(nullptr) {}
+
+    // Pool used to move entities in parallel, nullptr moves them on the calling thread
+    void setThreadPool(ThreadPool* pool) { threadPool = pool; }
+
+    // One fixed simulation tick for every entity in the batch
+    void update(MovementBatch& batch, float deltaTime) const;
+};
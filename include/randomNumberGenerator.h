@@ -3,6 +3,28 @@
 #include <random>
 #include <vector>
 #include <algorithm>
+#include <cstdint>
+#include <cstddef>
+
+/**
+ * @brief Bit generator behind a RandomNumberGenerator
+ *
+ * MT19937 is the default and keeps every existing seed producing the same
+ * mazes. The others are much smaller and faster, and draw bounded integers
+ * with Lemire's multiply-shift method instead of building a
+ * std::uniform_int_distribution per call:
+ *
+ * - XOSHIRO256: xoshiro256**, 32 bytes of state, the fastest general choice
+ * - PCG32: 16 bytes of state, O(log n) discard, 2^63 selectable streams
+ * - PHILOX: Philox4x32-10, counter based, O(1) discard and 2^64 streams
+ *   that never overlap, for parallel or chunked work that must stay deterministic
+ */
+enum class RandomEngine {
+    MT19937,
+    XOSHIRO256,
+    PCG32,
+    PHILOX
+};
 
 /**
  * @brief A wrapper class for random number generation using Mersenne Twister
@@ -13,8 +35,33 @@
  */
 class RandomNumberGenerator {
 private:
+    RandomEngine engine;
+    uint64_t seedValue;
+    uint64_t streamValue;
+
     std::mt19937 generator;  ///< Mersenne Twister random number generator
-    
+
+    uint64_t xoshiroState[4];
+
+    uint64_t pcgState;
+    uint64_t pcgIncrement;
+
+    uint64_t philoxPosition;      ///< 32-bit outputs consumed so far
+    uint64_t philoxBufferedBlock; ///< Counter of the block in philoxOutput
+    uint32_t philoxOutput[4];
+
+    void seedEngine();
+    void philoxBlock(uint64_t block);
+
+    /**
+     * @brief Uniform integer in [0, range), range > 0
+     *
+     * Lemire's multiply-shift for the fast engines, which only divides in
+     * the rare case that a rejection is possible. MT19937 keeps using
+     * std::uniform_int_distribution so its output does not change.
+     */
+    uint32_t bounded(uint32_t range);
+
 public:
     /**
      * @brief Default constructor with automatic seeding using current time
@@ -31,6 +78,57 @@ public:
      *             Using the same seed will produce identical sequences
      */
     RandomNumberGenerator(unsigned int seed);
+
+    /**
+     * @brief Constructor choosing the engine and stream
+     *
+     * @param seed The seed value, all 64 bits are used by the fast engines
+     * @param engine Bit generator to use
+     * @param stream Independent sequence for this seed, see setStream()
+     */
+    RandomNumberGenerator(uint64_t seed, RandomEngine engine, uint64_t stream = 0);
+
+    /**
+     * @brief Next raw 32 random bits
+     */
+    uint32_t next32();
+
+    /**
+     * @brief Next raw 64 random bits
+     */
+    uint64_t next64();
+
+    /**
+     * @brief Random value in the low bits of the result
+     *
+     * @param bits Number of random bits, 1 to 64
+     */
+    uint64_t randomBits(int bits);
+
+    /**
+     * @brief Fill a buffer with raw 32-bit random values
+     *
+     * Same values as calling next32() count times, without the per-call
+     * engine dispatch.
+     */
+    void fillRandom(uint32_t* out, size_t count);
+
+    /**
+     * @brief Skip ahead as if next32() had been called count times
+     *
+     * O(1) for PHILOX, O(log count) for PCG32, linear for the others.
+     */
+    void discard(uint64_t count);
+
+    /**
+     * @brief Switch to an independent sequence of the same seed, from its start
+     *
+     * PHILOX and PCG32 streams are distinct sequences by construction. For
+     * XOSHIRO256 and MT19937 the stream is hashed into the seed.
+     */
+    void setStream(uint64_t stream);
+
+    RandomEngine getEngine() const;
     
     /**
      * @brief Generate a random integer within a specified range (inclusive)
@@ -115,8 +213,7 @@ void RandomNumberGenerator::shuffle(std::vector<T>& vec) {
     // Fisher-Yates shuffle algorithm
     for (int i = vec.size() - 1; i > 0; i--) {
         // Generate random index between 0 and i (inclusive)
-        std::uniform_int_distribution<int> dist(0, i);
-        int j = dist(generator);
+        int j = static_cast<int>(bounded(static_cast<uint32_t>(i) + 1));
         
         // Swap elements at positions i and j
         std::swap(vec[i], vec[j]);
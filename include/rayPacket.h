@@ -0,0 +1,148 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+
+/**
+ * @brief Packet ray traversal kernels
+ *
+ * A packet is a group of 4 or 8 rays that share one origin, normally
+ * neighbouring screen columns. The packet kernels run the same DDA as
+ * Raycaster::castSingleRay, but step every lane in lockstep using SIMD
+ * registers. Lanes that have hit a wall are masked off and stop moving
+ * while the rest of the packet keeps walking.
+ *
+ * The 4 lane kernel is written with GCC/Clang vector extensions, which
+ * compile to SSE2 on x86 and NEON on ARM. The 8 lane kernel lives in its
+ * own translation unit built with AVX2 enabled, uses hardware gathers for
+ * the wall lookups, and is only called when the CPU reports AVX2 support.
+ */
+
+// Widest packet any kernel handles
+constexpr int MAX_PACKET_LANES = 8;
+
+/**
+ * @brief Input for one packet of rays sharing an origin
+ */
+struct RayPacketQuery {
+    const uint8_t* cells;       ///< MapGrid::data()
+    int stride;                 ///< MapGrid::getStride()
+    int startIndex;             ///< Flat grid index of the origin cell
+    int startCellX;             ///< Origin cell, must be inside the map
+    int startCellY;
+    float startX;               ///< Ray origin in map space
+    float startY;
+    float maxDistance;          ///< Lanes stop once their next cell is further than this
+    const float* dirX;          ///< Ray directions, one per lane, need not be normalized
+    const float* dirY;
+};
+
+/**
+ * @brief Per-lane results of a packet, in structure-of-arrays form
+ */
+struct RayPacketHits {
+    float distance[MAX_PACKET_LANES];       ///< In units of the ray direction (perpendicular for camera rays)
+    float hitX[MAX_PACKET_LANES];
+    float hitY[MAX_PACKET_LANES];
+    int32_t wallType[MAX_PACKET_LANES];     ///< 0 when the ray ran out of range
+    int32_t hitVerticalWall[MAX_PACKET_LANES]; ///< Non-zero when an x side was hit
+    int32_t steps[MAX_PACKET_LANES];        ///< DDA cells each lane stepped through
+};
+
+/**
+ * @brief Widest packet the running CPU supports (8 with AVX2, otherwise 4)
+ */
+int detectPacketLanes();
+
+void castRayPacket4(const RayPacketQuery& query, RayPacketHits& hits);
+
+#if defined(RAYCASTER_AVX2_KERNEL)
+void castRayPacket8(const RayPacketQuery& query, RayPacketHits& hits);
+#endif
+
+/**
+ * @brief Lockstep DDA shared by the packet kernels
+ *
+ * Each kernel instantiates this in its own translation unit with its own
+ * vector types and a LaneOps type providing gather(cells, index, active)
+ * and any(mask). It is static so a copy compiled with AVX2 can never be
+ * picked by the linker for a caller built without it.
+ *
+ * Inactive lanes keep the index of the last cell they entered, which is
+ * always a valid cell, so masked-off loads can never fault.
+ */
+template<typename FloatV, typename IntV, int LANES, typename LaneOps>
+static inline void traceRayPacket(const RayPacketQuery& query, RayPacketHits& hits) {
+    FloatV dirX, dirY;
+    std::memcpy(&dirX, query.dirX, sizeof(dirX));
+    std::memcpy(&dirY, query.dirY, sizeof(dirY));
+
+    const IntV zero = IntV{};
+    const IntV one = zero + 1;
+    const FloatV zeroF = FloatV{};
+
+    float startX = query.startX;
+    float startY = query.startY;
+    float cellX = static_cast<float>(query.startCellX);
+    float cellY = static_cast<float>(query.startCellY);
+    float nextCellX = static_cast<float>(query.startCellX + 1);
+    float nextCellY = static_cast<float>(query.startCellY + 1);
+
+    IntV negativeX = dirX < zeroF;
+    IntV negativeY = dirY < zeroF;
+
+    FloatV inverseX = 1.0f / dirX;
+    FloatV inverseY = 1.0f / dirY;
+    FloatV deltaDistX = negativeX ? -inverseX : inverseX;
+    FloatV deltaDistY = negativeY ? -inverseY : inverseY;
+
+    FloatV sideDistX = negativeX ? (startX - cellX) * deltaDistX : (nextCellX - startX) * deltaDistX;
+    FloatV sideDistY = negativeY ? (startY - cellY) * deltaDistY : (nextCellY - startY) * deltaDistY;
+
+    IntV cellStepX = negativeX ? -one : one;
+    IntV cellStepY = (negativeY ? -one : one) * query.stride;
+
+    IntV cellIndex = zero + query.startIndex;
+    IntV active = zero - 1;
+    IntV outOfRange = zero;
+    IntV verticalSide = zero;
+    IntV wallType = zero;
+    IntV steps = zero;
+    FloatV distance = zeroF;
+
+    do {
+        IntV crossesX = sideDistX < sideDistY;
+
+        // Distance to the side of the cell each lane is about to enter
+        FloatV entryDistance = crossesX ? sideDistX : sideDistY;
+        distance = active ? entryDistance : distance;
+        IntV tooFar = (entryDistance > query.maxDistance) & active;
+        outOfRange |= tooFar;
+        active &= ~tooFar;
+
+        IntV takeX = crossesX & active;
+        IntV takeY = ~crossesX & active;
+
+        sideDistX += takeX ? deltaDistX : zeroF;
+        sideDistY += takeY ? deltaDistY : zeroF;
+        cellIndex += (takeX & cellStepX) + (takeY & cellStepY);
+        verticalSide = active ? takeX : verticalSide;
+        steps -= active;
+
+        IntV cell = LaneOps::gather(query.cells, cellIndex, active);
+        IntV hit = (cell != zero) & active;
+        wallType = hit ? cell : wallType;
+        active &= ~hit;
+    } while (LaneOps::any(active));
+
+    FloatV wallDistance = outOfRange ? zeroF + query.maxDistance : distance;
+    FloatV hitX = startX + dirX * wallDistance;
+    FloatV hitY = startY + dirY * wallDistance;
+
+    std::memcpy(hits.distance, &wallDistance, sizeof(wallDistance));
+    std::memcpy(hits.hitX, &hitX, sizeof(hitX));
+    std::memcpy(hits.hitY, &hitY, sizeof(hitY));
+    std::memcpy(hits.wallType, &wallType, sizeof(wallType));
+    std::memcpy(hits.hitVerticalWall, &verticalSide, sizeof(verticalSide));
+    std::memcpy(hits.steps, &steps, sizeof(steps));
+}
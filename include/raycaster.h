@@ -0,0 +1,395 @@
+#pragma once
+
+#include "game.h"
+#include "threadPool.h"
+#include "distanceField.h"
+#include "rayPacket.h"
+#include <math.h>
+#include <algorithm>
+#include <atomic>
+#include <utility>
+#include <vector>
+
+class RayHit {
+public:
+    float distance;
+    float hitX;
+    float hitY;
+    int wallType;
+    bool hitVerticalWall;
+    float rayDirX;  // Direction the ray was cast in, not normalized
+    float rayDirY;
+};
+
+/**
+ * @brief One camera in a Raycaster::castViews batch, typically an agent
+ */
+struct ViewPose {
+    float x;
+    float y;
+    float angle;        // Radians, as Player::getAngle
+    float fieldOfView;  // Degrees, as Player::getFieldOfView
+};
+
+/**
+ * Caller owned results of a batch cast in structure-of-arrays form. Entry
+ * i belongs to ray i of castRays, or entry view * columns + column to that
+ * column of castViews. Storage only ever grows, so a buffer reused for
+ * batches of the same size never allocates.
+ */
+class RayBatchHits {
+public:
+    std::vector<float> distance;            // In units of the ray direction
+    std::vector<float> hitX;
+    std::vector<float> hitY;
+    std::vector<int32_t> wallType;          // 0 when the ray ran out of range
+    std::vector<uint8_t> hitVerticalWall;   // Non-zero when an x side was hit
+
+    void resize(int count) {
+        distance.resize(count);
+        hitX.resize(count);
+        hitY.resize(count);
+        wallType.resize(count);
+        hitVerticalWall.resize(count);
+    }
+
+    int size() const { return static_cast<int>(distance.size()); }
+
+    void store(int i, const RayHit& hit) {
+        distance[i] = hit.distance;
+        hitX[i] = hit.hitX;
+        hitY[i] = hit.hitY;
+        wallType[i] = hit.wallType;
+        hitVerticalWall[i] = hit.hitVerticalWall ? 1 : 0;
+    }
+
+    void store(int first, const RayPacketHits& hits, int lanes) {
+        for (int lane = 0; lane < lanes; lane++) {
+            distance[first + lane] = hits.distance[lane];
+            hitX[first + lane] = hits.hitX[lane];
+            hitY[first + lane] = hits.hitY[lane];
+            wallType[first + lane] = hits.wallType[lane];
+            hitVerticalWall[first + lane] = hits.hitVerticalWall[lane] != 0 ? 1 : 0;
+        }
+    }
+};
+
+enum class WallType {
+    HORIZONTAL,
+    VERTICAL
+};
+
+class Raycaster : public MapEditListener {
+public:
+    // View distance from which castAllRays uses the distance field when one is set
+    static constexpr float SKIP_MIN_DISTANCE = 12.0f;
+
+    // Segment queries are far cheaper than columns, so they are handed to the pool in bigger blocks
+    static constexpr int SEGMENTS_PER_TASK = 1024;
+
+private:
+    const WorldMap& worldMap;
+    float maxRayDistance;
+    ThreadPool* threadPool;
+    int tileWidth;
+    int packetLanes;
+
+    // Optional empty-space skipping, see setDistanceField
+    const DistanceField* distanceField;
+
+    // DDA cells stepped through by the last castAllRays, summed once per tile
+    std::atomic<uint64_t> lastCastSteps;
+
+    // Camera plane offset of every screen column, cameraX * tan(FOV / 2),
+    // and the angle of that column's ray from the view direction.
+    // Only rebuilt when the screen width or field of view changes.
+    std::vector<float> columnPlaneOffsets;
+    std::vector<float> columnBearings;
+    int columnTableWidth;
+    float columnTableFOV;
+
+    // Column ranges [first, end) castAllRays still has to cast this frame,
+    // at most tileWidth columns each so they can be spread over the pool
+    std::vector<std::pair<int, int>> castTasks;
+
+    /**
+     * Temporal ray cache, see setRayCacheEnabled. cachedHits is a copy of
+     * the last frame cast, since the caller's buffer may be swapped away.
+     * cachedBearings holds the angle of each cached hit from the cached
+     * view direction, which stays exact for hits carried over by a turn.
+     * staleColumns marks cached hits whose rays crossed an edited cell, see
+     * invalidateRayCacheRegion.
+     */
+    bool rayCacheEnabled;
+    bool rayCacheValid;
+    std::vector<RayHit> cachedHits;
+    std::vector<float> cachedBearings;
+    std::vector<float> nextBearings;
+    float cachedX;
+    float cachedY;
+    float cachedAngle;
+    float cachedFOV;
+    float cachedMaxDistance;
+    int cachedWidth;
+    const uint8_t* cachedCells;
+    const DistanceField* cachedDistanceField;
+    std::vector<uint8_t> staleColumns;
+    int staleCount;
+    int lastReusedColumns;
+
+    // Half width of the camera plane at distance 1 for a field of view in degrees
+    static float planeLengthFor(float FOV) {
+        float FOVRadians = FOV * (M_PI / 180.0f);
+        return tan(FOVRadians / 2.0f);
+    }
+
+    void updateColumnTable(int screenWidth, float FOV);
+
+    RayHit castSingleRay(float startX, float startY, float rayDirectionX, float rayDirectionY, uint64_t& steps) const;
+
+    /**
+     * Same walk as castSingleRay, but whenever the current cell is at least
+     * 2 cells from any wall the ray jumps straight out of the empty square
+     * around it, landing in the first cell past the square. Every skipped
+     * cell is known to be empty, so the first wall is still found, and one
+     * jump counts as one step.
+     */
+    RayHit castSkippingRay(float startX, float startY, float rayDirectionX, float rayDirectionY, uint64_t& steps) const;
+
+    bool useSkipping() const {
+        return distanceField && maxRayDistance >= SKIP_MIN_DISTANCE;
+    }
+
+    RayHit traceRay(float startX, float startY, float rayDirectionX, float rayDirectionY, uint64_t& steps) const {
+        if (useSkipping()) {
+            return castSkippingRay(startX, startY, rayDirectionX, rayDirectionY, steps);
+        }
+        return castSingleRay(startX, startY, rayDirectionX, rayDirectionY, steps);
+    }
+
+    // Rays per packet for an origin, packets need it inside the map and
+    // skipping rays are traced one at a time
+    int lanesFrom(float startX, float startY) const {
+        return (!useSkipping() && worldMap.getGrid().inBounds(floor(startX), floor(startY))) ? packetLanes : 1;
+    }
+
+    // Traces packetLanes rays from one origin together with the packet kernel
+    void tracePacket(float startX, float startY, const float* dirX, const float* dirY, RayPacketHits& hits) const;
+
+    // Casts columns [firstColumn, firstColumn + packetLanes) together with the
+    // packet kernel. dirX/dirY hold the camera plane ray direction of each column.
+    void castPacket(float startX, float startY, const float* dirX, const float* dirY, RayHit* rayResults, uint64_t& steps) const;
+
+    // Runs task(0 .. taskCount) on the pool, or inline without one
+    template<typename Func>
+    void runTasks(int taskCount, Func&& task) const {
+        if (!threadPool || taskCount <= 1) {
+            for (int i = 0; i < taskCount; i++) {
+                task(i);
+            }
+            return;
+        }
+        threadPool->parallelFor(taskCount, task);
+    }
+
+    // Queue columns [firstColumn, endColumn) for casting in tileWidth pieces
+    void addCastTasks(int firstColumn, int endColumn) {
+        for (int x = firstColumn; x < endColumn; x += tileWidth) {
+            castTasks.emplace_back(x, std::min(x + tileWidth, endColumn));
+        }
+    }
+
+    // Whether the cache holds a frame cast from this spot with the current settings
+    bool cacheMatches(float startX, float startY, int screenWidth) const {
+        return rayCacheValid && startX == cachedX && startY == cachedY && screenWidth == cachedWidth &&
+               columnTableFOV == cachedFOV && maxRayDistance == cachedMaxDistance &&
+               worldMap.getGrid().data() == cachedCells && (useSkipping() ? distanceField : nullptr) == cachedDistanceField;
+    }
+
+    /**
+     * The player turned in place. Every column whose ray lies within one
+     * column of a cached hit takes the nearest such hit, with its distance measured
+     * again along the new view direction, and the columns left over are
+     * queued in castTasks. Returns how many columns were reused.
+     *
+     * Matching goes by the true bearing of each cached hit rather than the
+     * column it was stored in, so repeated small turns never drift. The
+     * tolerance is a whole column because plane projection spaces columns
+     * more widely at the centre than at the edges, so after a turn the
+     * cached bearings no longer line up with the new columns. Within half
+     * a column would leave a scattering of columns to cast every frame.
+     */
+    int reuseTurnedColumns(float startX, float startY, float dirX, float dirY, float playerAngle,
+                           int screenWidth, RayHit* rayResults);
+
+    // Still camera with stale columns: queue the runs of them and keep every other cached bearing
+    void queueStaleColumns(int screenWidth);
+
+    // Whether the segment from (ax, ay) to (bx, by) enters the box [minX, maxX] x [minY, maxY]
+    static bool segmentEntersBox(float ax, float ay, float bx, float by,
+                                 float minX, float minY, float maxX, float maxY);
+
+    void storeCache(float startX, float startY, float playerAngle, int screenWidth, const RayHit* rayResults);
+
+public:
+    // Keeps a reference to the shared map, the WorldMap must outlive the raycaster
+    Raycaster(const WorldMap& worldMapObj) : worldMap(worldMapObj), maxRayDistance(6.0f),
+          threadPool(nullptr), tileWidth(64), packetLanes(detectPacketLanes()), distanceField(nullptr),
+          lastCastSteps(0), columnTableWidth(0), columnTableFOV(0.0f), rayCacheEnabled(false),
+          rayCacheValid(false), cachedX(0.0f), cachedY(0.0f), cachedAngle(0.0f), cachedFOV(0.0f),
+          cachedMaxDistance(0.0f), cachedWidth(0), cachedCells(nullptr), cachedDistanceField(nullptr),
+          staleCount(0), lastReusedColumns(0) {}
+
+    /**
+     * Cast a single ray along (rayDirX, rayDirY), which does not need to be
+     * normalized. The reported distance is measured in units of the direction
+     * vector, so for a camera plane ray (unit view direction plus a plane
+     * offset) it is already the perpendicular, fisheye free wall distance.
+     */
+    RayHit castRay(float startX, float startY, float rayDirX, float rayDirY) const {
+        uint64_t steps = 0;
+        return traceRay(startX, startY, rayDirX, rayDirY, steps);
+    }
+
+    // Convenience version that allocates a new result vector every call
+    std::vector<RayHit> castAllRays(Player& player, int screenWidth) {
+        std::vector<RayHit> rayResults(screenWidth);
+        castAllRays(player, screenWidth, rayResults.data());
+        return rayResults;
+    }
+
+    // Fills a caller owned buffer in place, it is only reallocated if it has to grow
+    void castAllRays(const Player& player, int screenWidth, std::vector<RayHit>& rayResults) {
+        rayResults.resize(screenWidth);
+        castAllRays(player, screenWidth, rayResults.data());
+    }
+
+    // Casts one ray per screen column into rayResults[0 .. screenWidth).
+    // With a thread pool set the columns are split into tiles and cast in
+    // parallel; every column owns its slot, so no locking is needed.
+    void castAllRays(const Player& player, int screenWidth, RayHit* rayResults);
+
+    /**
+     * Casts columnsPerView camera plane rays for each of viewCount cameras,
+     * exactly as castAllRays would for a Player with that pose. Results go
+     * to hits in view-major order. Views are split into tiles that are
+     * cast across the thread pool with packets, so one raycaster can serve
+     * every agent on a map.
+     *
+     * Only reads the map and the raycaster's settings, never the ray cache,
+     * and returns the DDA steps taken. Calls sharing a thread pool must
+     * still come from one thread at a time.
+     */
+    uint64_t castViews(const ViewPose* views, int viewCount, int columnsPerView, RayBatchHits& hits) const;
+
+    /**
+     * Casts count arbitrary rays, ray i starting at (originX[i], originY[i])
+     * along (dirX[i], dirY[i]), which need not be normalized. Neighbouring
+     * rays that share an origin, such as one agent's sight fan, are traced
+     * together as packets; the rest are traced one at a time. Same threading
+     * and read-only rules as castViews.
+     */
+    uint64_t castRays(const float* originX, const float* originY, const float* dirX, const float* dirY,
+                      int count, RayBatchHits& hits) const;
+
+    /**
+     * WorldMap::hasLineOfSight for count segments, segment i running from
+     * (ax[i], ay[i]) to (bx[i], by[i]). visible[i] is set to 1 when the
+     * segment is clear. Segments are split over the thread pool in blocks
+     * of SEGMENTS_PER_TASK. Same threading rules as castViews.
+     */
+    void testLinesOfSight(const float* ax, const float* ay, const float* bx, const float* by,
+                          int count, uint8_t* visible) const;
+
+    // WorldMap::findWallOnSegment for count segments, split as testLinesOfSight
+    void findWallsOnSegments(const float* ax, const float* ay, const float* bx, const float* by,
+                             int count, SegmentHit* hits) const;
+
+// This doesn't work, Fixed angle incrementation only works if the display is curver around the viewer in real life.  Vector Plane projection fixes this as done above
+/*
+        std::vector<RayHit> rayResults;
+
+        float FOVRadians = player.getFieldOfView() * (M_PI / 180.0f);
+
+        float angleStep = FOVRadians / screenWidth;
+        float startAngle = player.getAngle() - FOVRadians/2;
+
+        for (int i = 0; i < screenWidth; i++) {
+            float currentRayAngle = startAngle + (i * angleStep);
+
+            RayHit rayHit = castSingleRay(player.getX(), player.getY(), currentRayAngle, player.getAngle());
+
+            rayResults.push_back(rayHit);
+        }
+        return rayResults;
+    }
+*/
+    void setMaxDistance(float distance){ maxRayDistance = distance; }
+
+    // Pool used to cast columns in parallel, nullptr casts on the calling thread
+    void setThreadPool(ThreadPool* pool) { threadPool = pool; }
+
+    // Number of neighbouring columns each parallel task casts
+    void setTileWidth(int columns) { tileWidth = std::max(1, columns); }
+
+    // Rays traced per packet: 1 = scalar only, 4 = SSE/NEON, 8 = AVX2.
+    // Defaults to the widest the CPU supports and is clamped to it.
+    void setPacketLanes(int lanes) {
+        int widest = detectPacketLanes();
+        packetLanes = (lanes >= 8 && widest >= 8) ? 8 : (lanes >= 4 ? 4 : 1);
+    }
+
+    int getPacketLanes() const { return packetLanes; }
+
+    /**
+     * Empty-space skipping for long rays. The field must be built from this
+     * raycaster's map and updated whenever its cells change; nullptr turns
+     * skipping off. Below SKIP_MIN_DISTANCE the packet kernels are faster
+     * than skipping, so short view distances keep using them.
+     */
+    void setDistanceField(const DistanceField* field) { distanceField = field; }
+
+    /**
+     * Reuse the previous frame where the camera allows it. Standing still
+     * returns the last frame unchanged. Turning in place carries over every
+     * column still in view, off by at most one column, and casts only the
+     * newly exposed ones. Any move, or a change of screen width, field of
+     * view or view distance, casts the whole frame again.
+     *
+     * Rewrites through WorldMap::editGrid can't be seen from here, so
+     * whoever makes them must call invalidateRayCache(). Register the
+     * raycaster with WorldMap::addEditListener and setCell edits only
+     * recast the columns whose rays they touch.
+     */
+    void setRayCacheEnabled(bool enabled) {
+        rayCacheEnabled = enabled;
+        rayCacheValid = false;
+    }
+
+    // Next castAllRays casts every column again
+    void invalidateRayCache() { rayCacheValid = false; }
+
+    /**
+     * @brief Next castAllRays casts again every cached column whose ray crossed the cells
+     *
+     * A cached ray is only affected by the cells between the camera and
+     * its hit, so an edit elsewhere leaves it exact. The test is against
+     * the segment from the cached camera to the hit point, with the cell
+     * rect grown by a hair so a hit on its face counts. Covers a ray that
+     * stopped at a wall that opened as well as one that passes where a
+     * wall appeared. With a distance field, columns left cached can differ
+     * from a fresh cast by float rounding, since skipping then jumps
+     * through other cells.
+     */
+    void invalidateRayCacheRegion(const CellRect& cells);
+
+    void onCellsChanged(const MapGrid&, const CellRect& cells) override {
+        invalidateRayCacheRegion(cells);
+    }
+
+    // Columns the most recent castAllRays took from the ray cache instead of casting
+    int getLastReusedColumns() const { return lastReusedColumns; }
+
+    // DDA cells visited by the most recent castAllRays, for profiling
+    uint64_t getLastCastSteps() const { return lastCastSteps.load(std::memory_order_relaxed); }
+};
\ No newline at end of file
@@ -2,7 +2,9 @@
 
 #include <vector>
 #include <memory>
+#include <string>
 #include "randomNumberGenerator.h"
+#include "mazeFile.h"
 
 // Forward declarations
 class Rectangle;
@@ -90,6 +92,12 @@ private:
 
     RandomNumberGenerator rng;
 
+    // Seed recorded in saved mazes, 0 when seeded from the clock
+    int seed;
+
+    // Chambers still waiting to be divided, kept between runs so generation doesn't allocate
+    std::vector<Rectangle> chamberStack;
+
     void initializeGrid();
     void subdivide(Rectangle chamber);
     std::unique_ptr<Division> createDivision(const Rectangle& chamber);
@@ -106,7 +114,16 @@ public:
      */
     RecursiveDivisionMazeGenerator(int w, int h, int seed);
     
+    /**
+     * Generate the maze with an explicit chamber stack instead of recursion.
+     * Walls are written straight into the grid rows and no memory is
+     * allocated per chamber. Chambers are divided in the same order as
+     * generateMazeRecursive, so the same seed gives the same maze.
+     */
     void generateMaze();
+
+    // Original recursive implementation using Division objects, kept as a reference
+    void generateMazeRecursive();
     void printMaze() const;
     void printMazeAsArray() const;
     std::vector<int> getMazeAsVector() const;
@@ -114,4 +131,7 @@ public:
     int getWidth() const;
     int getHeight() const;
     const std::vector<std::vector<int>>& getMaze() const;
+
+    // Save as a binary maze file, GRID_BYTES can be memory-mapped on load
+    bool writeBinary(const std::string& path, MazeFileEncoding encoding = MazeFileEncoding::GRID_BYTES) const;
 };
\ No newline at end of file
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <algorithm>
+
+/**
+ * @brief Picks the internal render resolution that keeps frames on budget
+ *
+ * Each level casts one ray per columnWidth window columns and renders one
+ * framebuffer row per rowHeight window rows; the frame is stretched to
+ * the window when it is presented. Horizontal resolution goes first, as
+ * ray casting and column drawing scale with it, while halving the rows
+ * only helps the per-pixel work.
+ *
+ * update() is fed the measured time of every frame. The time is smoothed,
+ * the level drops as soon as the smoothed time goes over budget, and it
+ * only goes back up when the finer level is predicted to fit with room to
+ * spare. A level change is given SETTLE_FRAMES frames to show up in the
+ * measurements before the next decision, so it doesn't oscillate.
+ */
+class ResolutionController {
+public:
+    struct Level {
+        int columnWidth;
+        int rowHeight;
+    };
+
+    static constexpr int LEVEL_COUNT = 4;
+    static constexpr int SETTLE_FRAMES = 30;
+
+    // Weight of the newest frame in the smoothed frame time
+    static constexpr double SMOOTHING = 0.1;
+
+    // A finer level is only taken when it is predicted to use at most this much of the budget
+    static constexpr double RAISE_HEADROOM = 0.8;
+
+private:
+    static constexpr Level LEVELS[LEVEL_COUNT] = { { 1, 1 }, { 2, 1 }, { 2, 2 }, { 4, 2 } };
+
+    double targetMs;
+    double smoothedMs;
+    int level;
+    int framesSinceChange;
+    bool enabled;
+
+    static double pixelShare(int index) {
+        return 1.0 / (LEVELS[index].columnWidth * LEVELS[index].rowHeight);
+    }
+
+    void setLevel(int newLevel) {
+        // Assume the cost scales with the pixels drawn until new measurements come in
+        smoothedMs *= pixelShare(newLevel) / pixelShare(level);
+        level = newLevel;
+        framesSinceChange = 0;
+    }
+
+public:
+    // targetFrameMs is the frame time to stay under, 1000 / 60 for 60 frames a second
+    explicit ResolutionController(double targetFrameMs = 1000.0 / 60.0)
+        : targetMs(targetFrameMs), smoothedMs(0.0), level(0), framesSinceChange(0), enabled(true) {}
+
+    void setTargetFrameMs(double frameMs) { targetMs = frameMs; }
+
+    // Disabled always renders at full resolution
+    void setEnabled(bool on) {
+        enabled = on;
+        if (!enabled) {
+            level = 0;
+        }
+    }
+
+    // frameMs is the last frame's work, leave out any time spent waiting for vsync or a frame cap
+    void update(double frameMs);
+
+    int getLevel() const { return level; }
+    int getColumnWidth() const { return LEVELS[level].columnWidth; }
+    int getRowHeight() const { return LEVELS[level].rowHeight; }
+    double getSmoothedFrameMs() const { return smoothedMs; }
+
+    // Rays to cast for a window this wide
+    int getCastWidth(int windowWidth) const { return std::max(1, windowWidth / getColumnWidth()); }
+
+    // Framebuffer rows for a window this tall
+    int getRenderHeight(int windowHeight) const { return std::max(1, windowHeight / getRowHeight()); }
+};
@@ -0,0 +1,55 @@
+#pragma once
+
+#include "spriteTextures.h"
+
+#include <cstdint>
+#include <vector>
+
+/**
+ * Billboard sprites standing on the floor, pickups and NPCs alike, in
+ * structure-of-arrays form so SpriteRenderer's cull streams through the
+ * positions alone. Entry i of every vector is sprite i.
+ *
+ * Sprites are plain indices, not objects: remove() moves the last sprite
+ * into the freed slot, so indices are only stable until the next remove.
+ * Storage only ever grows, so a pool that is refilled to the same size
+ * doesn't allocate.
+ */
+class SpritePool {
+public:
+    std::vector<float> x;           // Centre on the floor, in cells
+    std::vector<float> y;
+    std::vector<float> scale;       // Height and width in cells, 1 is as tall as a wall
+    std::vector<uint8_t> type;      // SpriteType
+
+    // Returns the new sprite's index
+    int add(float spriteX, float spriteY, uint8_t spriteType, float spriteScale = 0.5f) {
+        x.push_back(spriteX);
+        y.push_back(spriteY);
+        scale.push_back(spriteScale);
+        type.push_back(spriteType);
+        return static_cast<int>(x.size()) - 1;
+    }
+
+    // Swaps the last sprite into index, which then refers to it
+    void remove(int index) {
+        int last = static_cast<int>(x.size()) - 1;
+        x[index] = x[last];
+        y[index] = y[last];
+        scale[index] = scale[last];
+        type[index] = type[last];
+        x.pop_back();
+        y.pop_back();
+        scale.pop_back();
+        type.pop_back();
+    }
+
+    void clear() {
+        x.clear();
+        y.clear();
+        scale.clear();
+        type.clear();
+    }
+
+    int size() const { return static_cast<int>(x.size()); }
+};
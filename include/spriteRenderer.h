@@ -0,0 +1,116 @@
+#pragma once
+
+#include "threadPool.h"
+#include "spritePool.h"
+#include "spriteTextures.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <math.h>
+#include <vector>
+
+/**
+ * @brief Draws a SpritePool's billboards over a frame of walls
+ *
+ * Each frame the pool is culled against the view frustum, with the
+ * farthest wall in view as the far plane, in one pass over its
+ * positions. The survivors are projected, dropped if a coarse
+ * copy of the wall depths hides them entirely, sorted far to near with a
+ * radix sort, then drawn as vertical strips clipped against the
+ * per-column wall depths. Drawing far to near lets nearer sprites cover
+ * farther ones without a per-pixel depth buffer; the wall depths hide
+ * sprites behind walls column by column.
+ *
+ * The camera matches Raycaster::castAllRays and FloorCaster, and depths
+ * are perpendicular to the view direction like RayHit::distance, so
+ * sprites and walls meet exactly. Sprites stand on the floor.
+ *
+ * Columns are split over the thread pool in blocks of COLUMNS_PER_TASK.
+ * Each block draws every sprite that overlaps it, so blocks never write
+ * the same pixel and the frame is the same for any thread count. All
+ * working buffers are reused, so drawing a pool that doesn't grow
+ * doesn't allocate.
+ */
+class SpriteRenderer {
+public:
+    static constexpr int COLUMNS_PER_TASK = 64;
+
+    // Columns per entry of the coarse wall depths used to reject hidden sprites early
+    static constexpr int OCCLUSION_BLOCK = 8;
+
+    // Sprites closer than this to the camera plane are dropped
+    static constexpr float NEAR_DISTANCE = 0.05f;
+
+private:
+    // A visible sprite in screen space, unclipped edges and the clipped pixel ranges
+    struct ProjectedSprite {
+        float depth;
+        float left;
+        float top;
+        float texelsPerColumn;
+        float texelsPerRow;
+        int firstColumn;
+        int endColumn;
+        int firstRow;
+        int endRow;
+        int level;
+        int type;
+    };
+
+    const SpriteTextureAtlas& textures;
+    ThreadPool* threadPool;
+
+    std::vector<int32_t> candidates;
+    std::vector<float> blockDepths;
+    std::vector<ProjectedSprite> projected;
+    std::vector<uint32_t> sortKeys;
+    std::vector<uint32_t> sortKeysScratch;
+    std::vector<int32_t> drawOrder;
+    std::vector<int32_t> drawOrderScratch;
+    int lastVisible;
+
+    /**
+     * Sorts the first count entries of projected far to near by their
+     * sortKeys, returning their indices in draw order. A positive float's
+     * bits order the same way as its value, so the keys are the inverted
+     * depth bits. Least significant digit first, 8 bits a pass; passes
+     * where every key shares the digit are skipped.
+     */
+    const int32_t* sortFarToNear(int count);
+
+    // Rows [first, end) of one sprite column, leaving transparent texels' pixels alone
+    static void drawStrip(uint32_t* column, int pitch, int firstRow, int endRow, const uint32_t* strip,
+                          uint32_t v, uint32_t vStep, uint32_t vMask) {
+        uint32_t* pixel = column + static_cast<ptrdiff_t>(firstRow) * pitch;
+        for (int y = firstRow; y < endRow; y++) {
+            uint32_t texel = strip[(v >> 16) & vMask];
+            uint32_t solid = 0u - (texel >> 31);
+            *pixel = (texel & solid) | (*pixel & ~solid);
+            v += vStep;
+            pixel += pitch;
+        }
+    }
+
+public:
+    // The atlas must outlive the renderer
+    explicit SpriteRenderer(const SpriteTextureAtlas& atlas)
+        : textures(atlas), threadPool(nullptr), lastVisible(0) {}
+
+    // Pool used to draw columns in parallel, nullptr draws on the calling thread
+    void setThreadPool(ThreadPool* pool) { threadPool = pool; }
+
+    /**
+     * @brief Draws the sprites into a width x height XRGB frame
+     *
+     * @param columnDepths Wall distance of every column, RayHit::distance
+     * @param projectionScale On-screen height of a wall one cell away, as FloorCaster::draw
+     */
+    void draw(uint32_t* pixels, int pitch, int width, int height, const float* columnDepths,
+              const SpritePool& sprites, float cameraX, float cameraY, float angle, float fieldOfView,
+              float projectionScale);
+
+    // Sprites that survived culling in the last draw
+    int getLastVisible() const { return lastVisible; }
+};
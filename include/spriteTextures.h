@@ -0,0 +1,116 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <algorithm>
+#include <math.h>
+
+// What a sprite looks like, indexes SpriteTextureAtlas
+enum SpriteType : uint8_t {
+    SPRITE_PICKUP,
+    SPRITE_HEALTH,
+    SPRITE_NPC,
+    SPRITE_TYPE_COUNT
+};
+
+/**
+ * @brief Mip-mapped billboard textures, one per SpriteType
+ *
+ * Laid out like WallTextureAtlas: TEXTURE_SIZE texels square, a full mip
+ * chain, column-major so one screen strip reads contiguous texels. Texels
+ * are 32-bit XRGB with the top byte OPAQUE where the sprite is solid and 0
+ * where the background shows through, so drawing can pick per pixel
+ * without a branch.
+ *
+ * Mip levels keep a texel solid when at least half of the four above it
+ * are, then average the solid ones, so far sprites keep their outline.
+ *
+ * Each texture column also records the span of texels from its first to
+ * last solid one, so drawing can skip the transparent rows above and
+ * below a sprite instead of testing them.
+ */
+class SpriteTextureAtlas {
+public:
+    static constexpr int TEXTURE_BITS = 6;
+    static constexpr int TEXTURE_SIZE = 1 << TEXTURE_BITS;
+    static constexpr int MIP_LEVELS = TEXTURE_BITS + 1;
+    static constexpr uint32_t OPAQUE = 0xff000000u;
+
+private:
+    static constexpr int TEXELS_PER_TEXTURE = (4 * TEXTURE_SIZE * TEXTURE_SIZE - 1) / 3;
+    static constexpr int COLUMNS_PER_TEXTURE = 2 * TEXTURE_SIZE - 1;
+
+    std::vector<uint32_t> texels;
+    int levelOffsets[MIP_LEVELS];
+
+    // First and one past the last solid texel of every column, COLUMNS_PER_TEXTURE pairs a texture
+    std::vector<uint8_t> solidSpans;
+    int levelColumnOffsets[MIP_LEVELS];
+
+    static uint32_t packColor(int r, int g, int b) {
+        return OPAQUE |
+               (static_cast<uint32_t>(std::min(std::max(r, 0), 255)) << 16) |
+               (static_cast<uint32_t>(std::min(std::max(g, 0), 255)) << 8) |
+               static_cast<uint32_t>(std::min(std::max(b, 0), 255));
+    }
+
+    // Level 0 texel (u, v) of a sprite, u across and v down, 0 where transparent
+    static uint32_t generateTexel(int type, int u, int v);
+
+    // 2x2 filter of the level above that keeps the outline, see the class comment
+    static uint32_t average(uint32_t a, uint32_t b, uint32_t c, uint32_t d) {
+        uint32_t samples[4] = { a, b, c, d };
+        uint32_t red = 0;
+        uint32_t green = 0;
+        uint32_t blue = 0;
+        uint32_t solid = 0;
+        for (uint32_t sample : samples) {
+            if (sample & OPAQUE) {
+                red += sample >> 16 & 0xff;
+                green += sample >> 8 & 0xff;
+                blue += sample & 0xff;
+                solid++;
+            }
+        }
+        if (solid < 2) {
+            return 0;
+        }
+        return OPAQUE | ((red + solid / 2) / solid) << 16 | ((green + solid / 2) / solid) << 8 | (blue + solid / 2) / solid;
+    }
+
+    void build();
+
+    uint32_t* writableTexture(int type, int level) {
+        return texels.data() + static_cast<size_t>(type) * TEXELS_PER_TEXTURE + levelOffsets[level];
+    }
+
+public:
+    SpriteTextureAtlas() {
+        build();
+    }
+
+    // First texel of the given level, column-major with (TEXTURE_SIZE >> level) texels per column.
+    // Unknown types use the last texture
+    const uint32_t* texture(int type, int level) const {
+        type = std::min(std::max(type, 0), SPRITE_TYPE_COUNT - 1);
+        return texels.data() + static_cast<size_t>(type) * TEXELS_PER_TEXTURE + levelOffsets[level];
+    }
+
+    // Texels [span[0], span[1]) of column u hold every solid texel of it, empty for a clear column
+    const uint8_t* solidSpan(int type, int level, int u) const {
+        type = std::min(std::max(type, 0), SPRITE_TYPE_COUNT - 1);
+        return &solidSpans[(static_cast<size_t>(type) * COLUMNS_PER_TEXTURE + levelColumnOffsets[level] + u) * 2];
+    }
+
+    // Coarsest level that still has at least one texel per screen pixel
+    static int mipLevelFor(float pixels) {
+        int level = 0;
+        float texelsPerPixel = TEXTURE_SIZE / std::max(pixels, 1.0f);
+        while (level + 1 < MIP_LEVELS && texelsPerPixel >= 2.0f) {
+            texelsPerPixel *= 0.5f;
+            level++;
+        }
+        return level;
+    }
+};
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <cstdint>
+#include <type_traits>
+
+/**
+ * @brief Persistent pool of worker threads for data-parallel loops
+ *
+ * Workers are started once and sleep between jobs. A job is a task count
+ * plus a callable taking the task index; tasks are handed out through an
+ * atomic counter, so there is no queue and no allocation per job. The
+ * calling thread works on the job as well and returns once every task
+ * has finished.
+ *
+ * Only one job runs at a time, parallelFor must be called from a single
+ * thread.
+ */
+class ThreadPool {
+private:
+    std::vector<std::thread> workers;
+    std::mutex mutex;
+    std::condition_variable wakeWorkers;
+    std::condition_variable jobDone;
+
+    // Current job, only written while no worker is inside it
+    void (*jobInvoke)(void* context, int task);
+    void* jobContext;
+    int jobTaskCount;
+    std::atomic<int> nextTask;
+
+    int activeWorkers;
+    uint64_t jobGeneration;
+    bool stopping;
+
+    void runTasks();
+    void workerLoop();
+
+    // Type-erased body of parallelFor: invoke(context, task) for every task
+    void run(void (*invoke)(void*, int), void* context, int taskCount);
+
+public:
+    /**
+     * @param threadCount Total threads working on a job, including the caller
+     *                    (0 = one per hardware thread, 1 = run everything inline)
+     */
+    explicit ThreadPool(int threadCount = 0);
+
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    int getThreadCount() const { return static_cast<int>(workers.size()) + 1; }
+
+    // Calls func(task) for every task in [0, taskCount) and blocks until all are done
+    template<typename Func>
+    void parallelFor(int taskCount, Func&& func) {
+        using FuncType = typename std::remove_reference<Func>::type;
+        run([](void* context, int task) { (*static_cast<FuncType*>(context))(task); },
+            const_cast<void*>(static_cast<const void*>(&func)), taskCount);
+    }
+};
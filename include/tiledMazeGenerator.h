@@ -0,0 +1,80 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include "randomNumberGenerator.h"
+
+class ThreadPool;
+
+// Generator run inside each tile
+enum class TiledMazeAlgorithm {
+    DEPTH_FIRST,
+    RECURSIVE_DIVISION
+};
+
+/**
+ * @brief Builds a large maze from independently generated tiles
+ *
+ * The maze is split into a grid of square tiles of tileSize cells that
+ * share their edge walls, with the last row and column of tiles stretched
+ * over any leftover cells. Every tile is generated on its own with
+ * DepthFirstMazeGenerator or RecursiveDivisionMazeGenerator, in parallel
+ * when a ThreadPool is set, and copied into the shared grid. Tiles only
+ * write their interior, so no two tasks ever touch the same cell.
+ *
+ * Each tile gets its own child seed derived from the master seed and the
+ * tile index. Afterwards a random spanning tree over the tiles, drawn from
+ * the master seed, picks which shared walls get one seam passage. Both
+ * generators produce perfect mazes, and joining them along a tree keeps
+ * the whole maze perfect and connected.
+ *
+ * Nothing depends on which thread ran which tile, so for a given seed the
+ * output is bit-identical across runs and for any thread count.
+ */
+class TiledMazeGenerator {
+private:
+    int width, height;
+    int tileSize;
+    int tilesX, tilesY;
+    uint32_t masterSeed;
+    TiledMazeAlgorithm algorithm;
+    ThreadPool* threadPool;
+
+    // 2D maze representation: 1 = wall, 0 = path (2 = entrance/exit for depth-first)
+    std::vector<std::vector<int>> maze;
+
+    // First cell of tile column/row i, tiles overlap by their one cell edge wall
+    int tileStartX(int tileX) const;
+    int tileStartY(int tileY) const;
+    int tileEndX(int tileX) const; // Inclusive, the tile's right edge wall
+    int tileEndY(int tileY) const;
+
+    unsigned int childSeed(int tileIndex) const;
+    void generateTile(int tileIndex);
+    void carveSeams();
+
+    // Random position along an edge where both neighbouring tiles always have open cells
+    int pickSeamOffset(RandomNumberGenerator& rng, int edgeLength);
+
+public:
+    /**
+     * @param w Width of the maze, made odd if even
+     * @param h Height of the maze, made odd if even
+     * @param seed Master seed (0 = use current time, resolved once here)
+     * @param algorithm Generator to run inside each tile
+     * @param tileSize Edge length of a tile including its walls, made odd, at least 5
+     */
+    TiledMazeGenerator(int w, int h, unsigned int seed = 0,
+                       TiledMazeAlgorithm algorithm = TiledMazeAlgorithm::DEPTH_FIRST, int tileSize = 255);
+
+    // Pool to generate the tiles on, nullptr generates them on the calling thread
+    void setThreadPool(ThreadPool* pool);
+
+    void generateMaze();
+
+    int getWidth() const;
+    int getHeight() const;
+    int getTileCountX() const;
+    int getTileCountY() const;
+    const std::vector<std::vector<int>>& getMaze() const;
+};
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <atomic>
+
+/**
+ * @brief Lock-free handoff of whole frames from one producer to one consumer
+ *
+ * Three slots: the writer fills one, the reader holds one, and the third
+ * is the most recently published frame waiting to be picked up. Publishing
+ * and acquiring each swap a slot index with the waiting one in a single
+ * atomic exchange, so neither side ever blocks or copies a frame, and the
+ * slot a side is working on is never touched by the other.
+ *
+ * If the writer publishes twice before the reader acquires, the older
+ * frame is dropped and the writer gets its slot back. Slots are reused
+ * forever, so frames holding vectors stop allocating once every slot has
+ * been sized.
+ *
+ * Exactly one thread may write and exactly one may read.
+ */
+template<typename T>
+class TripleBuffer {
+private:
+    static constexpr int INDEX_MASK = 3;
+    static constexpr int FRESH = 4;     // Set while the waiting slot holds a frame the reader hasn't taken
+
+    T slots[3];
+    std::atomic<int> waiting;
+    int writeIndex;                     // Writer thread only
+    int readIndex;                      // Reader thread only
+
+public:
+    TripleBuffer() : waiting(1), writeIndex(0), readIndex(2) {}
+
+    TripleBuffer(const TripleBuffer&) = delete;
+    TripleBuffer& operator=(const TripleBuffer&) = delete;
+
+    // Direct access for sizing the slots up front, only before either side has started
+    T& slot(int index) { return slots[index]; }
+
+    // Slot the writer fills next, stays its own until publish()
+    T& writeSlot() { return slots[writeIndex]; }
+
+    // Hand the written slot over as the newest frame
+    void publish() {
+        writeIndex = waiting.exchange(writeIndex | FRESH, std::memory_order_acq_rel) & INDEX_MASK;
+    }
+
+    // True while a published frame is waiting for the reader
+    bool hasFreshFrame() const {
+        return (waiting.load(std::memory_order_acquire) & FRESH) != 0;
+    }
+
+    // Take the newest published frame if there is one; false keeps the current read slot
+    bool acquire() {
+        if (!hasFreshFrame()) {
+            return false;
+        }
+        readIndex = waiting.exchange(readIndex, std::memory_order_acq_rel) & INDEX_MASK;
+        return true;
+    }
+
+    // Frame the reader holds, unchanged until the next successful acquire()
+    const T& readSlot() const { return slots[readIndex]; }
+};
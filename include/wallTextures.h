@@ -0,0 +1,152 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <algorithm>
+#include <math.h>
+
+/**
+ * @brief Mip-mapped wall textures packed into one atlas, indexed by wall type
+ *
+ * The floor and ceiling textures sit in the same atlas after the walls,
+ * see FloorCaster.
+ *
+ * Every texture is TEXTURE_SIZE texels square with a full mip chain down
+ * to 1x1. Texels are stored column-major, so the texels of one vertical
+ * strip are contiguous and a screen column reads memory sequentially
+ * while the framebuffer is walked downwards.
+ *
+ * drawColumn picks the mip level per column from the projected wall
+ * height, so far walls read a small level that stays in cache instead of
+ * skipping through the full size texture, and steps V in 16.16 fixed point.
+ *
+ * The textures are generated procedurally, so there are no image files to
+ * ship or load. Pixels are 32-bit XRGB, the same as Framebuffer.
+ */
+class WallTextureAtlas {
+public:
+    static constexpr int TEXTURE_BITS = 6;
+    static constexpr int TEXTURE_SIZE = 1 << TEXTURE_BITS;
+    static constexpr int MIP_LEVELS = TEXTURE_BITS + 1;
+
+    // Wall types with their own texture, every other type uses the last wall slot
+    static constexpr int WALL_TEXTURE_COUNT = 3;
+    static constexpr int FLOOR_SLOT = WALL_TEXTURE_COUNT;
+    static constexpr int CEILING_SLOT = WALL_TEXTURE_COUNT + 1;
+    static constexpr int TEXTURE_COUNT = WALL_TEXTURE_COUNT + 2;
+
+private:
+    // Texels in one texture including its whole mip chain
+    static constexpr int TEXELS_PER_TEXTURE = (4 * TEXTURE_SIZE * TEXTURE_SIZE - 1) / 3;
+
+    std::vector<uint32_t> texels;
+    int levelOffsets[MIP_LEVELS];
+
+    static uint32_t packColor(int r, int g, int b) {
+        return (static_cast<uint32_t>(std::min(std::max(r, 0), 255)) << 16) |
+               (static_cast<uint32_t>(std::min(std::max(g, 0), 255)) << 8) |
+               static_cast<uint32_t>(std::min(std::max(b, 0), 255));
+    }
+
+    // Cheap repeatable per-texel noise in [0, 1)
+    static float noise(int x, int y, int salt) {
+        uint32_t h = static_cast<uint32_t>(x) * 374761393u + static_cast<uint32_t>(y) * 668265263u +
+                     static_cast<uint32_t>(salt) * 2246822519u;
+        h = (h ^ (h >> 13)) * 1274126177u;
+        return ((h ^ (h >> 16)) & 0xffff) / 65536.0f;
+    }
+
+    // Level 0 texel (u, v) of texture slot, u across and v down the wall
+    static uint32_t generateTexel(int slot, int u, int v);
+
+    // 2x2 box filter of the level above, averaging each channel
+    static uint32_t average(uint32_t a, uint32_t b, uint32_t c, uint32_t d) {
+        uint32_t red = ((a >> 16 & 0xff) + (b >> 16 & 0xff) + (c >> 16 & 0xff) + (d >> 16 & 0xff) + 2) / 4;
+        uint32_t green = ((a >> 8 & 0xff) + (b >> 8 & 0xff) + (c >> 8 & 0xff) + (d >> 8 & 0xff) + 2) / 4;
+        uint32_t blue = ((a & 0xff) + (b & 0xff) + (c & 0xff) + (d & 0xff) + 2) / 4;
+        return (red << 16) | (green << 8) | blue;
+    }
+
+    void build();
+
+    uint32_t* writableTexture(int slot, int level) {
+        return texels.data() + static_cast<size_t>(slot) * TEXELS_PER_TEXTURE + levelOffsets[level];
+    }
+
+public:
+    WallTextureAtlas() {
+        build();
+    }
+
+    // Texture slot used for a wall type, types start at 1 (0 is empty)
+    static int slotFor(int wallType) {
+        return std::min(std::max(wallType - 1, 0), WALL_TEXTURE_COUNT - 1);
+    }
+
+    // First texel of the given level, column-major with (TEXTURE_SIZE >> level) texels per column
+    const uint32_t* texture(int slot, int level) const {
+        return texels.data() + static_cast<size_t>(slot) * TEXELS_PER_TEXTURE + levelOffsets[level];
+    }
+
+    /**
+     * Horizontal texture coordinate of a ray hit. The fractional part of
+     * the hit along the wall face, mirrored on the faces seen from the
+     * positive side so textures read the same way round on every face.
+     */
+    static float wallU(float hitX, float hitY, bool hitVerticalWall, float rayDirX, float rayDirY) {
+        float along = hitVerticalWall ? hitY : hitX;
+        float u = along - floor(along);
+        if ((hitVerticalWall && rayDirX > 0) || (!hitVerticalWall && rayDirY < 0)) {
+            u = 1.0f - u;
+        }
+        return u;
+    }
+
+    // Coarsest level that still has at least one texel per screen row
+    static int mipLevelFor(float lineHeight) {
+        int level = 0;
+        float texelsPerRow = TEXTURE_SIZE / std::max(lineHeight, 1.0f);
+        while (level + 1 < MIP_LEVELS && texelsPerRow >= 2.0f) {
+            texelsPerRow *= 0.5f;
+            level++;
+        }
+        return level;
+    }
+
+    /**
+     * @brief Draws rows [firstRow, endRow) of one textured wall column
+     *
+     * @param column Pixel of row 0 in the column being drawn
+     * @param pitch Pixels between rows
+     * @param wallTop Screen row of the top of the unclipped wall slice
+     * @param lineHeight Unclipped height of the slice in rows
+     * @param u Horizontal texture coordinate in [0, 1)
+     */
+    void drawColumn(uint32_t* column, int pitch, int firstRow, int endRow, float wallTop, float lineHeight,
+                    int wallType, float u) const {
+        if (firstRow >= endRow) {
+            return;
+        }
+
+        int level = mipLevelFor(lineHeight);
+        int size = TEXTURE_SIZE >> level;
+        int texelU = std::min(static_cast<int>(u * size), size - 1);
+        const uint32_t* strip = texture(slotFor(wallType), level) + texelU * size;
+
+        // 16.16 fixed point V, sampled at the centre of each screen row. A
+        // slice under a row tall draws at most one row, and clamping it keeps
+        // the step, at most size texels, well inside 16.16
+        float step = size / std::max(lineHeight, 1.0f);
+        uint32_t vStep = static_cast<uint32_t>(step * 65536.0f);
+        uint32_t v = static_cast<uint32_t>(std::max((firstRow + 0.5f - wallTop) * step, 0.0f) * 65536.0f);
+        uint32_t vMask = static_cast<uint32_t>(size - 1);
+
+        uint32_t* pixel = column + static_cast<ptrdiff_t>(firstRow) * pitch;
+        for (int y = firstRow; y < endRow; y++) {
+            *pixel = strip[(v >> 16) & vMask];
+            v += vStep;
+            pixel += pitch;
+        }
+    }
+};
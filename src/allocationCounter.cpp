@@ -0,0 +1,40 @@
+#include "allocationCounter.h"
+
+#ifndef NDEBUG
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+static std::atomic<uint64_t> heapAllocationCount{0};
+
+static void* countedAllocate(std::size_t size) {
+    heapAllocationCount.fetch_add(1, std::memory_order_relaxed);
+    if (size == 0) {
+        size = 1;
+    }
+    void* memory = std::malloc(size);
+    if (!memory) {
+        throw std::bad_alloc();
+    }
+    return memory;
+}
+
+void* operator new(std::size_t size) { return countedAllocate(size); }
+void* operator new[](std::size_t size) { return countedAllocate(size); }
+void operator delete(void* memory) noexcept { std::free(memory); }
+void operator delete[](void* memory) noexcept { std::free(memory); }
+void operator delete(void* memory, std::size_t) noexcept { std::free(memory); }
+void operator delete[](void* memory, std::size_t) noexcept { std::free(memory); }
+
+uint64_t getHeapAllocationCount() {
+    return heapAllocationCount.load(std::memory_order_relaxed);
+}
+
+#else
+
+uint64_t getHeapAllocationCount() {
+    return 0;
+}
+
+#endif
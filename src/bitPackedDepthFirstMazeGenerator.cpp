@@ -0,0 +1,124 @@
+#include "bitPackedDepthFirstMazeGenerator.h"
+#include <stdexcept>
+#include <limits>
+#include <ctime>
+
+const uint8_t BitPackedDepthFirstMazeGenerator::directionOrders[24][4] = {
+    {0, 1, 2, 3}, {0, 1, 3, 2}, {0, 2, 1, 3}, {0, 2, 3, 1}, {0, 3, 1, 2}, {0, 3, 2, 1},
+    {1, 0, 2, 3}, {1, 0, 3, 2}, {1, 2, 0, 3}, {1, 2, 3, 0}, {1, 3, 0, 2}, {1, 3, 2, 0},
+    {2, 0, 1, 3}, {2, 0, 3, 1}, {2, 1, 0, 3}, {2, 1, 3, 0}, {2, 3, 0, 1}, {2, 3, 1, 0},
+    {3, 0, 1, 2}, {3, 0, 2, 1}, {3, 1, 0, 2}, {3, 1, 2, 0}, {3, 2, 0, 1}, {3, 2, 1, 0}
+};
+
+/**
+ * @brief Set up an all-wall bitset for a w x h maze
+ *
+ * Only the bitset is allocated here; the stack is reserved when a maze is
+ * generated.
+ */
+BitPackedDepthFirstMazeGenerator::BitPackedDepthFirstMazeGenerator(int w, int h, unsigned int seed)
+    : width(w), height(h), rng(seed == 0 ? static_cast<uint64_t>(std::time(nullptr)) : seed, RandomEngine::PCG32), seed(seed) {
+    uint64_t cellCount = static_cast<uint64_t>(width) * height;
+    if (width <= 0 || height <= 0 || cellCount > std::numeric_limits<uint32_t>::max()) {
+        throw std::invalid_argument("maze size must be positive and fit in a 32-bit cell index");
+    }
+    walls.assign((cellCount + 63) / 64, ~uint64_t(0));
+}
+
+/**
+ * @brief Depth-first search with backtracking over the bitset
+ *
+ * Same steps as DepthFirstMazeGenerator::generateMaze: from the cell on top
+ * of the stack, try the four directions in a random order and carve into
+ * the first unvisited cell two steps away, otherwise backtrack.
+ */
+void BitPackedDepthFirstMazeGenerator::generateMaze() {
+    const int dx[4] = {0, 1, 0, -1};
+    const int dy[4] = {-1, 0, 1, 0};
+
+    // The stack never holds more than one entry per carved cell
+    uint64_t carvedCells = static_cast<uint64_t>((width + 1) / 2) * ((height + 1) / 2);
+    stack.clear();
+    stack.reserve(carvedCells);
+
+    uint32_t start = static_cast<uint32_t>(1 * width + 1);
+    clearWall(start);
+    stack.push_back(start);
+
+    while (!stack.empty()) {
+        uint32_t current = stack.back();
+        int currentX = static_cast<int>(current % width);
+        int currentY = static_cast<int>(current / width);
+
+        const uint8_t* order = directionOrders[rng.randomInt(0, 23)];
+
+        bool carved = false;
+        for (int i = 0; i < 4; i++) {
+            int dir = order[i];
+            int nextX = currentX + dx[dir] * 2;
+            int nextY = currentY + dy[dir] * 2;
+
+            if (nextX < 0 || nextX >= width || nextY < 0 || nextY >= height) {
+                continue;
+            }
+
+            uint32_t next = static_cast<uint32_t>(nextY) * width + nextX;
+            if (!testWall(next)) {
+                continue; // Already visited
+            }
+
+            uint32_t between = static_cast<uint32_t>(currentY + dy[dir]) * width + (currentX + dx[dir]);
+            clearWall(between);
+            clearWall(next);
+            stack.push_back(next);
+            carved = true;
+            break;
+        }
+
+        if (!carved) {
+            stack.pop_back();
+        }
+    }
+
+    // Entrance and exit keep their wall bit, getWallType() reports them as type 2
+}
+
+bool BitPackedDepthFirstMazeGenerator::isWall(int x, int y) const {
+    if (x < 0 || x >= width || y < 0 || y >= height) {
+        return true;
+    }
+    return testWall(static_cast<uint64_t>(y) * width + x);
+}
+
+int BitPackedDepthFirstMazeGenerator::getWallType(int x, int y) const {
+    if ((x == 0 && y == 1) || (x == width - 1 && y == height - 2)) {
+        return 2;
+    }
+    return isWall(x, y) ? 1 : 0;
+}
+
+std::vector<std::vector<int>> BitPackedDepthFirstMazeGenerator::toMaze() const {
+    std::vector<std::vector<int>> maze(height, std::vector<int>(width));
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+            maze[y][x] = getWallType(x, y);
+        }
+    }
+    return maze;
+}
+
+const std::vector<uint64_t>& BitPackedDepthFirstMazeGenerator::getPackedMaze() const {
+    return walls;
+}
+
+int BitPackedDepthFirstMazeGenerator::getWidth() const {
+    return width;
+}
+
+int BitPackedDepthFirstMazeGenerator::getHeight() const {
+    return height;
+}
+
+bool BitPackedDepthFirstMazeGenerator::writeBinary(const std::string& path) const {
+    return writePackedMazeFile(path, walls, width, height, MazeFileGenerator::BIT_PACKED_DEPTH_FIRST, seed);
+}
@@ -0,0 +1,181 @@
+#include "chunkedWorld.h"
+
+uint64_t ChunkedWorld::chunkHash(ChunkCoord coord, uint64_t salt) const {
+    uint64_t z = chunkKey(coord) ^ (static_cast<uint64_t>(seed) * 0xD1B54A32D192ED03ull) ^ (salt * 0x9E3779B97F4A7C15ull);
+    z += 0x9E3779B97F4A7C15ull;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+void ChunkedWorld::generateChunk(ChunkCoord coord, std::vector<uint8_t>& cells) const {
+    // 0 would mean "seed from the clock"
+    unsigned int chunkSeed = static_cast<unsigned int>(chunkHash(coord, 0));
+    DepthFirstMazeGenerator generator(chunkSize + 1, chunkSize + 1, chunkSeed == 0 ? 1 : chunkSeed);
+    generator.generateMaze();
+    const std::vector<std::vector<int>>& maze = generator.getMaze();
+
+    cells.resize(static_cast<size_t>(chunkSize) * chunkSize);
+    for (int y = 0; y < chunkSize; y++) {
+        for (int x = 0; x < chunkSize; x++) {
+            cells[static_cast<size_t>(y) * chunkSize + x] = static_cast<uint8_t>(maze[y][x]);
+        }
+    }
+
+    // West column and north row are plain walls apart from one seam each,
+    // at an odd offset where the cells on both sides are always open
+    for (int i = 0; i < chunkSize; i++) {
+        cells[static_cast<size_t>(i) * chunkSize] = 1;
+        cells[i] = 1;
+    }
+    int halfSize = chunkSize / 2;
+    int westSeam = 1 + 2 * static_cast<int>(chunkHash(coord, 1) % halfSize);
+    int northSeam = 1 + 2 * static_cast<int>(chunkHash(coord, 2) % halfSize);
+    cells[static_cast<size_t>(westSeam) * chunkSize] = 0;
+    cells[northSeam] = 0;
+}
+
+bool ChunkedWorld::copyCachedChunk(ChunkCoord coord, std::vector<uint8_t>& cells) {
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    auto found = chunkIndex.find(chunkKey(coord));
+    if (found == chunkIndex.end()) {
+        return false;
+    }
+    chunks.splice(chunks.begin(), chunks, found->second);
+    cells = found->second->cells;
+    return true;
+}
+
+bool ChunkedWorld::isCached(ChunkCoord coord) {
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    return chunkIndex.count(chunkKey(coord)) != 0;
+}
+
+void ChunkedWorld::insertChunk(ChunkCoord coord, std::vector<uint8_t>&& cells) {
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    uint64_t key = chunkKey(coord);
+    if (chunkIndex.count(key)) {
+        return; // Generated twice at once, both copies are identical
+    }
+    chunks.push_front(Chunk{ coord, std::move(cells) });
+    chunkIndex[key] = chunks.begin();
+
+    while (chunks.size() > cacheCapacity) {
+        chunkIndex.erase(chunkKey(chunks.back().coord));
+        chunks.pop_back();
+    }
+}
+
+void ChunkedWorld::prefetchLoop() {
+    std::vector<uint8_t> cells;
+    while (true) {
+        ChunkCoord coord;
+        {
+            std::unique_lock<std::mutex> lock(prefetchMutex);
+            prefetchReady.wait(lock, [this] { return stopping || !prefetchQueue.empty(); });
+            if (stopping) {
+                return;
+            }
+            coord = prefetchQueue.front();
+            prefetchQueue.pop_front();
+        }
+
+        if (!isCached(coord)) {
+            generateChunk(coord, cells);
+            insertChunk(coord, std::move(cells));
+        }
+    }
+}
+
+void ChunkedWorld::requestPrefetch(float angle) {
+    float dirX = std::cos(angle);
+    float dirY = std::sin(angle);
+    const float threshold = 0.38f; // About 22 degrees off an axis still counts as facing it
+    int stepX = dirX > threshold ? 1 : (dirX < -threshold ? -1 : 0);
+    int stepY = dirY > threshold ? 1 : (dirY < -threshold ? -1 : 0);
+
+    if (windowCentre.x == lastPrefetchCentre.x && windowCentre.y == lastPrefetchCentre.y &&
+        stepX == lastPrefetchStepX && stepY == lastPrefetchStepY) {
+        return;
+    }
+    lastPrefetchCentre = windowCentre;
+    lastPrefetchStepX = stepX;
+    lastPrefetchStepY = stepY;
+
+    int reach = windowChunks / 2 + 1;
+    {
+        std::lock_guard<std::mutex> lock(prefetchMutex);
+        prefetchQueue.clear(); // Requests for the old heading are stale now
+        for (int i = -reach; i <= reach; i++) {
+            if (stepX != 0) {
+                prefetchQueue.push_back({ windowCentre.x + stepX * reach, windowCentre.y + i });
+            }
+            if (stepY != 0) {
+                prefetchQueue.push_back({ windowCentre.x + i, windowCentre.y + stepY * reach });
+            }
+        }
+    }
+    prefetchReady.notify_one();
+}
+
+void ChunkedWorld::rebuildWindow(ChunkCoord centre) {
+    windowCentre = centre;
+    int radius = windowChunks / 2;
+    MapGrid& grid = window.editGrid();
+
+    std::vector<uint8_t> cells;
+    for (int cy = 0; cy < windowChunks; cy++) {
+        for (int cx = 0; cx < windowChunks; cx++) {
+            ChunkCoord coord = { centre.x - radius + cx, centre.y - radius + cy };
+            if (!copyCachedChunk(coord, cells)) {
+                generateChunk(coord, cells);
+                insertChunk(coord, std::vector<uint8_t>(cells));
+            }
+            for (int y = 0; y < chunkSize; y++) {
+                std::memcpy(grid.row(cy * chunkSize + y) + cx * chunkSize,
+                            &cells[static_cast<size_t>(y) * chunkSize], chunkSize);
+            }
+        }
+    }
+}
+
+ChunkedWorld::ChunkedWorld(unsigned int seed, int chunkSize, int windowChunks, size_t cacheCapacity)
+    : seed(seed), chunkSize(std::max(4, chunkSize + (chunkSize & 1))),
+      windowChunks(windowChunks | 1),
+      cacheCapacity(std::max(cacheCapacity, static_cast<size_t>(this->windowChunks + 2) * (this->windowChunks + 2))),
+      window(this->windowChunks * this->chunkSize, this->windowChunks * this->chunkSize),
+      windowCentre{ 0, 0 }, stopping(false),
+      lastPrefetchCentre{ 0, 0 }, lastPrefetchStepX(2), lastPrefetchStepY(2) {
+    rebuildWindow(windowCentre);
+    prefetchThread = std::thread([this] { prefetchLoop(); });
+}
+
+ChunkedWorld::~ChunkedWorld() {
+    {
+        std::lock_guard<std::mutex> lock(prefetchMutex);
+        stopping = true;
+    }
+    prefetchReady.notify_all();
+    prefetchThread.join();
+}
+
+size_t ChunkedWorld::getResidentChunkCount() {
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    return chunks.size();
+}
+
+bool ChunkedWorld::update(Player& player) {
+    int radius = windowChunks / 2;
+    float localX = player.getX() - radius * chunkSize;
+    float localY = player.getY() - radius * chunkSize;
+    ChunkCoord offset = chunkOf(localX, localY);
+
+    bool moved = offset.x != 0 || offset.y != 0;
+    if (moved) {
+        rebuildWindow({ windowCentre.x + offset.x, windowCentre.y + offset.y });
+        player.setPosition(player.getX() - offset.x * chunkSize, player.getY() - offset.y * chunkSize);
+    }
+
+    requestPrefetch(player.getAngle());
+    return moved;
+}
@@ -1,5 +1,3 @@
-#pragma once
-
 #include "depthFirstMazeGenerator.h"
 #include <iostream>
 #include <ctime>
@@ -65,7 +63,7 @@ std::vector<int> DepthFirstMazeGenerator::getRandomDirections() {
  * @param h Height of the maze (preferably odd for proper wall/path structure)
  * @param seed Random seed (0 = auto-seed with current time)
  */
-DepthFirstMazeGenerator::DepthFirstMazeGenerator(int w, int h, unsigned int seed) : width(w), height(h) {
+DepthFirstMazeGenerator::DepthFirstMazeGenerator(int w, int h, unsigned int seed) : width(w), height(h), seed(seed) {
     // Initialize random number generator with appropriate seed
     if (seed == 0) {
         rng = RandomNumberGenerator();  // Auto-seed with current time
@@ -89,7 +87,7 @@ DepthFirstMazeGenerator::DepthFirstMazeGenerator(int w, int h, unsigned int seed
  * @param externalRng Reference to an existing RandomNumberGenerator
  */
 DepthFirstMazeGenerator::DepthFirstMazeGenerator(int w, int h, RandomNumberGenerator& externalRng) 
-    : width(w), height(h), rng(externalRng) {
+    : width(w), height(h), rng(externalRng), seed(0) {
     // Initialize maze grid with all walls (1s)
     maze.assign(height, std::vector<int>(width, 1));
 }
@@ -284,4 +282,16 @@ const std::vector<std::vector<int>>& DepthFirstMazeGenerator::getMaze() const {
  */
 void DepthFirstMazeGenerator::reseedRNG(unsigned int seed) {
     rng.setSeed(seed);
+    this->seed = seed;
+}
+
+/**
+ * @brief Save the maze as a binary maze file
+ *
+ * @param path File to write
+ * @param encoding GRID_BYTES to memory-map on load, BITS for the smallest file
+ * @return false if the file could not be written
+ */
+bool DepthFirstMazeGenerator::writeBinary(const std::string& path, MazeFileEncoding encoding) const {
+    return writeMazeFile(path, maze, MazeFileGenerator::DEPTH_FIRST, seed, encoding);
 }
\ No newline at end of file
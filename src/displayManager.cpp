@@ -0,0 +1,37 @@
+#include "displayManager.h"
+
+bool DisplayManager::init() {
+    if (initialized) {
+        return true;
+    }
+    if (!SDL_Init(SDL_INIT_VIDEO)) {
+        std::cerr << "SDL_Init failed: " << SDL_GetError() << std::endl;
+        return false;
+    }
+    initialized = true;
+    running = true;
+    return true;
+}
+
+void DisplayManager::pumpEvents() {
+    ScopedTimer timer(profiler, ProfileSection::EVENTS);
+    SDL_Event event;
+    while (SDL_PollEvent(&event)) {
+        if (event.type == SDL_EVENT_QUIT) {
+            running = false;
+        }
+        else if (event.type == SDL_EVENT_WINDOW_CLOSE_REQUESTED) {
+            if (mapWindowID != 0 && event.window.windowID == mapWindowID) {
+                mapWindowCloseRequested = true;
+                mapWindowID = 0;
+            } else if (event.window.windowID == gameWindowID) {
+                running = false;
+            }
+        }
+        else if (event.type == SDL_EVENT_KEY_DOWN) {
+            if (event.key.key == SDLK_ESCAPE) {
+                running = false;
+            }
+        }
+    }
+}
@@ -0,0 +1,62 @@
+#include "distanceField.h"
+
+void DistanceField::recompute(const MapGrid& grid, int x0, int y0, int x1, int y1) {
+    x0 = std::max(x0, 0);
+    y0 = std::max(y0, 0);
+    x1 = std::min(x1, width);
+    y1 = std::min(y1, height);
+
+    for (int y = y0; y < y1; y++) {
+        for (int x = x0; x < x1; x++) {
+            cell(x, y) = grid.at(x, y) != 0 ? 0 : MAX_DISTANCE;
+        }
+    }
+
+    // Forward pass pulls from the row above and the left
+    for (int y = y0; y < y1; y++) {
+        for (int x = x0; x < x1; x++) {
+            uint8_t& d = cell(x, y);
+            if (d == 0) {
+                continue;
+            }
+            int nearest = std::min(std::min(cell(x - 1, y), cell(x - 1, y - 1)),
+                                   std::min(cell(x, y - 1), cell(x + 1, y - 1)));
+            d = static_cast<uint8_t>(std::min<int>(d, nearest + 1));
+        }
+    }
+
+    // Backward pass pulls from the row below and the right
+    for (int y = y1 - 1; y >= y0; y--) {
+        for (int x = x1 - 1; x >= x0; x--) {
+            uint8_t& d = cell(x, y);
+            if (d == 0) {
+                continue;
+            }
+            int nearest = std::min(std::min(cell(x + 1, y), cell(x + 1, y + 1)),
+                                   std::min(cell(x, y + 1), cell(x - 1, y + 1)));
+            d = static_cast<uint8_t>(std::min<int>(d, nearest + 1));
+        }
+    }
+}
+
+void DistanceField::build(const MapGrid& grid) {
+    width = grid.getWidth();
+    height = grid.getHeight();
+    stride = grid.getStride();
+
+    // Border and padding stay 0, they are all walls
+    distances.assign(grid.getByteSize(), 0);
+    recompute(grid, 0, 0, width, height);
+}
+
+void DistanceField::update(const MapGrid& grid, int x0, int y0, int x1, int y1) {
+    if (grid.getWidth() != width || grid.getHeight() != height || grid.getStride() != stride) {
+        build(grid);
+        return;
+    }
+    recompute(grid, x0 - MAX_DISTANCE, y0 - MAX_DISTANCE, x1 + MAX_DISTANCE, y1 + MAX_DISTANCE);
+}
+
+void DistanceField::onCellsChanged(const MapGrid& grid, const CellRect& cells) {
+    update(grid, cells.x0, cells.y0, cells.x1, cells.y1);
+}
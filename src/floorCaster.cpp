@@ -0,0 +1,74 @@
+#include "floorCaster.h"
+
+void FloorCaster::drawSpan(const FloorSpanQuery& query) const {
+#if defined(RAYCASTER_AVX2_KERNEL)
+    if (wideSpans) {
+        drawFloorSpan16(query);
+        return;
+    }
+#endif
+    drawFloorSpan8(query);
+}
+
+void FloorCaster::draw(uint32_t* pixels, int pitch, int width, int height, float cameraX, float cameraY,
+          float angle, float fieldOfView, float projectionScale) const {
+    if (width <= 0 || height <= 0) {
+        return;
+    }
+
+    float dirX = cos(angle);
+    float dirY = sin(angle);
+    float FOVRadians = fieldOfView * (M_PI / 180.0f);
+    float planeLength = tan(FOVRadians / 2.0f);
+
+    // Camera plane, perpendicular to the view direction
+    float planeX = -dirY * planeLength;
+    float planeY = dirX * planeLength;
+
+    // On a row boundary, so no row centre sits on the horizon at an infinite distance
+    float horizon = static_cast<float>(height / 2);
+    float halfScale = projectionScale / 2.0f;
+
+    auto drawRows = [&](int task) {
+        int firstRow = task * ROWS_PER_TASK;
+        int endRow = std::min(firstRow + ROWS_PER_TASK, height);
+
+        for (int y = firstRow; y < endRow; y++) {
+            // Rows above the horizon see the ceiling at the mirrored distance
+            float rowCentre = y + 0.5f;
+            bool ceiling = rowCentre < horizon;
+            float rowDistance = halfScale / (ceiling ? horizon - rowCentre : rowCentre - horizon);
+
+            FloorSpanQuery query;
+            query.startX = cameraX + rowDistance * (dirX - planeX);
+            query.startY = cameraY + rowDistance * (dirY - planeY);
+            query.stepX = rowDistance * 2.0f * planeX / width;
+            query.stepY = rowDistance * 2.0f * planeY / width;
+
+            // The kernels truncate, so shift the whole span by whole cells,
+            // where the texture repeats, until none of it is negative
+            float spanX = query.stepX * (width - 1);
+            float spanY = query.stepY * (width - 1);
+            query.startX -= floor(std::min(query.startX, query.startX + spanX));
+            query.startY -= floor(std::min(query.startY, query.startY + spanY));
+
+            float step = sqrt(query.stepX * query.stepX + query.stepY * query.stepY);
+            int level = WallTextureAtlas::mipLevelFor(step > 0.0f ? 1.0f / step : 1.0f);
+            int slot = ceiling ? WallTextureAtlas::CEILING_SLOT : WallTextureAtlas::FLOOR_SLOT;
+            query.texture = textures.texture(slot, level);
+            query.sizeBits = WallTextureAtlas::TEXTURE_BITS - level;
+            query.pixels = pixels + static_cast<ptrdiff_t>(y) * pitch;
+            query.count = width;
+            drawSpan(query);
+        }
+    };
+
+    int taskCount = (height + ROWS_PER_TASK - 1) / ROWS_PER_TASK;
+    if (!threadPool || taskCount <= 1) {
+        for (int task = 0; task < taskCount; task++) {
+            drawRows(task);
+        }
+        return;
+    }
+    threadPool->parallelFor(taskCount, drawRows);
+}
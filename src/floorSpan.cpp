@@ -0,0 +1,24 @@
+#include "floorSpan.h"
+
+typedef float SpanFloat4 __attribute__((vector_size(16)));
+typedef int32_t SpanInt4 __attribute__((vector_size(16)));
+
+/**
+ * @brief Texel lookups for the 8 pixel kernel
+ *
+ * There is no gather below AVX2, so each lane loads its texel on its own.
+ * The position and index maths stays in SSE2/NEON registers.
+ */
+struct SpanGather4 {
+    static void load(const uint32_t* texture, SpanInt4 index, SpanInt4& texels) {
+        SpanInt4 result = {
+            static_cast<int32_t>(texture[index[0]]), static_cast<int32_t>(texture[index[1]]),
+            static_cast<int32_t>(texture[index[2]]), static_cast<int32_t>(texture[index[3]])
+        };
+        texels = result;
+    }
+};
+
+void drawFloorSpan8(const FloorSpanQuery& query) {
+    traceFloorSpan<SpanFloat4, SpanInt4, 4, 2, SpanGather4>(query);
+}
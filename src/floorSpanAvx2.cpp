@@ -0,0 +1,27 @@
+// Built with -mavx2 (see CMakeLists.txt). Keep this file free of anything
+// but the kernel so no AVX2 code can end up shared with other translation units.
+#if defined(RAYCASTER_AVX2_KERNEL)
+
+#include <immintrin.h>
+#include "floorSpan.h"
+
+typedef float SpanFloat8 __attribute__((vector_size(32)));
+typedef int32_t SpanInt8 __attribute__((vector_size(32)));
+
+/**
+ * @brief Texel lookups for the 16 pixel kernel
+ *
+ * One AVX2 gather per 8 lanes. Indices are always masked into the
+ * texture, so no lane can fault.
+ */
+struct SpanGather8 {
+    static void load(const uint32_t* texture, SpanInt8 index, SpanInt8& texels) {
+        texels = (SpanInt8)_mm256_i32gather_epi32(reinterpret_cast<const int*>(texture), (__m256i)index, 4);
+    }
+};
+
+void drawFloorSpan16(const FloorSpanQuery& query) {
+    traceFloorSpan<SpanFloat8, SpanInt8, 8, 2, SpanGather8>(query);
+}
+
+#endif
@@ -0,0 +1,173 @@
+#include "flowField.h"
+
+void FlowField::propagate(const uint8_t* cells) {
+    while (!queue.empty()) {
+        std::pop_heap(queue.begin(), queue.end(), std::greater<QueueEntry>());
+        QueueEntry entry = queue.back();
+        queue.pop_back();
+        if (entry.first != distances[entry.second]) {
+            continue;
+        }
+        uint32_t next = entry.first + 1;
+        for (int offset : neighbourOffsets) {
+            int neighbour = entry.second + offset;
+            if (cells[neighbour] == 0 && distances[neighbour] > next) {
+                pushCell(neighbour, next);
+            }
+        }
+    }
+}
+
+uint32_t FlowField::distanceFromNeighbours(const uint8_t* cells, int cell) const {
+    if (cell == goalCell) {
+        return 0;
+    }
+    uint32_t best = UNREACHABLE;
+    for (int offset : neighbourOffsets) {
+        int neighbour = cell + offset;
+        if (cells[neighbour] == 0 && distances[neighbour] < best) {
+            best = distances[neighbour];
+        }
+    }
+    return best == UNREACHABLE ? UNREACHABLE : best + 1;
+}
+
+void FlowField::build(const MapGrid& grid, int goalX, int goalY) {
+    setShape(grid);
+    distances.assign(grid.getByteSize(), UNREACHABLE);
+    queue.clear();
+    goalCell = grid.inBounds(goalX, goalY) ? grid.index(goalX, goalY) : -1;
+    if (goalCell < 0 || grid.data()[goalCell] != 0) {
+        return;
+    }
+
+    // One source, so plain first-in first-out order already visits cells by distance
+    const uint8_t* cells = grid.data();
+    distances[goalCell] = 0;
+    queue.push_back({ 0, goalCell });
+    for (size_t head = 0; head < queue.size(); head++) {
+        uint32_t next = queue[head].first + 1;
+        for (int offset : neighbourOffsets) {
+            int neighbour = queue[head].second + offset;
+            if (cells[neighbour] == 0 && distances[neighbour] == UNREACHABLE) {
+                distances[neighbour] = next;
+                queue.push_back({ next, neighbour });
+            }
+        }
+    }
+    queue.clear();
+}
+
+void FlowField::update(const MapGrid& grid, int x0, int y0, int x1, int y1) {
+    if (grid.getWidth() != width || grid.getHeight() != height || grid.getStride() != stride) {
+        int goalX = goalCell >= 0 ? goalCell % stride - MapGrid::BORDER : -1;
+        int goalY = goalCell >= 0 ? goalCell / stride - MapGrid::BORDER : -1;
+        build(grid, goalX, goalY);
+        return;
+    }
+
+    x0 = std::max(x0, 0);
+    y0 = std::max(y0, 0);
+    x1 = std::min(x1, width);
+    y1 = std::min(y1, height);
+    if (x0 >= x1 || y0 >= y1 || goalCell < 0) {
+        return;
+    }
+    const uint8_t* cells = grid.data();
+
+    // Clear the edited cells, then every cell left without a neighbour a
+    // step closer to the goal. Taking cells nearest first means all of a
+    // cell's possible supports are settled before it is looked at.
+    cleared.clear();
+    queue.clear();
+    for (int y = y0; y < y1; y++) {
+        for (int x = x0; x < x1; x++) {
+            int cell = grid.index(x, y);
+            if (distances[cell] != UNREACHABLE) {
+                queue.push_back({ distances[cell], cell });
+                distances[cell] = UNREACHABLE;
+            }
+        }
+    }
+    std::make_heap(queue.begin(), queue.end(), std::greater<QueueEntry>());
+    while (!queue.empty()) {
+        std::pop_heap(queue.begin(), queue.end(), std::greater<QueueEntry>());
+        QueueEntry entry = queue.back();
+        queue.pop_back();
+        cleared.push_back({ entry.second, entry.first });
+
+        uint32_t downstream = entry.first + 1;
+        for (int offset : neighbourOffsets) {
+            int neighbour = entry.second + offset;
+            if (distances[neighbour] != downstream) {
+                continue;
+            }
+            bool supported = false;
+            for (int supportOffset : neighbourOffsets) {
+                supported |= distances[neighbour + supportOffset] == entry.first;
+            }
+            if (!supported) {
+                distances[neighbour] = UNREACHABLE;
+                queue.push_back({ downstream, neighbour });
+                std::push_heap(queue.begin(), queue.end(), std::greater<QueueEntry>());
+            }
+        }
+    }
+
+    // Refill from whatever still has a distance, newly opened cells included
+    queue.clear();
+    auto seed = [&](int cell) {
+        if (cells[cell] != 0) {
+            return;
+        }
+        uint32_t distance = distanceFromNeighbours(cells, cell);
+        if (distance < distances[cell]) {
+            pushCell(cell, distance);
+        }
+    };
+    for (const auto& entry : cleared) {
+        seed(entry.first);
+    }
+    for (int y = y0; y < y1; y++) {
+        for (int x = x0; x < x1; x++) {
+            seed(grid.index(x, y));
+        }
+    }
+    propagate(cells);
+}
+
+void FlowField::onCellsChanged(const MapGrid& grid, const CellRect& cells) {
+    update(grid, cells.x0, cells.y0, cells.x1, cells.y1);
+}
+
+int FlowField::nextCell(int cell) const {
+    uint32_t distance = distances[cell];
+    if (distance == 0 || distance == UNREACHABLE) {
+        return -1;
+    }
+    for (int offset : neighbourOffsets) {
+        if (distances[cell + offset] == distance - 1) {
+            return cell + offset;
+        }
+    }
+    return -1;
+}
+
+bool FlowField::steer(float x, float y, float& dirX, float& dirY) const {
+    int cellX = static_cast<int>(floor(x));
+    int cellY = static_cast<int>(floor(y));
+    if (cellX < 0 || cellY < 0 || cellX >= width || cellY >= height) {
+        return false;
+    }
+    int next = nextCell((cellY + MapGrid::BORDER) * stride + (cellX + MapGrid::BORDER));
+    if (next < 0) {
+        return false;
+    }
+
+    float toX = (next % stride - MapGrid::BORDER) + 0.5f - x;
+    float toY = (next / stride - MapGrid::BORDER) + 0.5f - y;
+    float length = sqrt(toX * toX + toY * toY);
+    dirX = toX / length;
+    dirY = toY / length;
+    return true;
+}
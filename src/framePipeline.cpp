@@ -0,0 +1,92 @@
+#include "framePipeline.h"
+
+void FramePipeline::notifyFrameChanged() {
+    // Taking the lock orders this with a waiter between its check and its wait
+    { std::lock_guard<std::mutex> lock(parkMutex); }
+    frameChanged.notify_all();
+}
+
+void FramePipeline::simulationLoop() {
+    while (!stopping.load(std::memory_order_relaxed)) {
+        {
+            std::unique_lock<std::mutex> lock(parkMutex);
+            frameChanged.wait(lock, [&] {
+                return stopping.load(std::memory_order_relaxed) || !frames.hasFreshFrame();
+            });
+        }
+        if (stopping.load(std::memory_order_relaxed)) {
+            return;
+        }
+        simulateFrame();
+    }
+}
+
+void FramePipeline::start() {
+    if (simulationThread.joinable()) {
+        return;
+    }
+    stopping.store(false, std::memory_order_relaxed);
+    threaded.store(true, std::memory_order_relaxed);
+    simulationThread = std::thread([this] { simulationLoop(); });
+}
+
+void FramePipeline::stop() {
+    if (!simulationThread.joinable()) {
+        return;
+    }
+    stopping.store(true, std::memory_order_relaxed);
+    notifyFrameChanged();
+    simulationThread.join();
+    threaded.store(false, std::memory_order_relaxed);
+}
+
+void FramePipeline::simulateFrame() {
+    int ticks = scheduler.beginFrame();
+    uint32_t keys = heldKeys.load(std::memory_order_relaxed);
+    for (int tick = 0; tick < ticks; tick++) {
+        player.applyInput(keys, scheduler.getTickSeconds());
+        if (chunkedWorld && chunkedWorld->update(player)) {
+            raycaster.invalidateRayCache();
+            mapVersion++;
+        }
+    }
+    if (editedMap) {
+        editedMap->flushEdits();
+    }
+
+    RenderFrame& frame = frames.writeSlot();
+    frame.columnWidth = columnWidth.load(std::memory_order_relaxed);
+    frame.rowHeight = rowHeight.load(std::memory_order_relaxed);
+    int castWidth = std::max(1, screenWidth / frame.columnWidth);
+
+    frame.castStart = SDL_GetPerformanceCounter();
+    frame.rays.resize(castWidth);
+    raycaster.castAllRays(player, castWidth, frame.rays);
+    frame.castEnd = SDL_GetPerformanceCounter();
+
+    frame.ddaSteps = raycaster.getLastCastSteps();
+    frame.player = player;
+    frame.mapVersion = mapVersion;
+    frames.publish();
+    scheduler.endFrame();
+
+    if (isThreaded()) {
+        notifyFrameChanged();
+    }
+}
+
+bool FramePipeline::acquireFrame(double timeoutMs) {
+    if (isThreaded() && !frames.hasFreshFrame()) {
+        std::unique_lock<std::mutex> lock(parkMutex);
+        frameChanged.wait_for(lock, std::chrono::duration<double, std::milli>(timeoutMs),
+                              [&] { return frames.hasFreshFrame(); });
+    }
+    if (!frames.acquire()) {
+        return false;
+    }
+    // Lets the simulation thread start on the next frame
+    if (isThreaded()) {
+        notifyFrameChanged();
+    }
+    return true;
+}
@@ -0,0 +1,100 @@
+#include "frameProfiler.h"
+
+const char* FrameProfiler::getSectionName(ProfileSection section) {
+    switch (section) {
+        case ProfileSection::RAY_CASTING: return "ray_casting";
+        case ProfileSection::GAME_RENDER: return "game_render";
+        case ProfileSection::GRID_RENDER: return "grid_render";
+        case ProfileSection::PLAYER_RENDER: return "player_render";
+        case ProfileSection::EVENTS: return "events";
+        case ProfileSection::PRESENT: return "present";
+        default: return "unknown";
+    }
+}
+
+void FrameProfiler::enableTracing(size_t maxEvents) {
+    tracing = true;
+    maxTraceEvents = maxEvents;
+    traceEvents.reserve(maxEvents);
+}
+
+void FrameProfiler::beginFrame() {
+    current = FrameRecord();
+    frameStart = now();
+    inFrame = true;
+}
+
+void FrameProfiler::endFrame() {
+    if (!inFrame) {
+        return;
+    }
+    current.frameMs = toMs(now() - frameStart);
+    history[historyNext] = current;
+    historyNext = (historyNext + 1) % HISTORY;
+    historyCount = std::min(historyCount + 1, HISTORY);
+    framesRecorded++;
+    inFrame = false;
+}
+
+void FrameProfiler::addSample(ProfileSection section, uint64_t start, uint64_t end) {
+    current.sectionMs[static_cast<int>(section)] += toMs(end - start);
+    if (tracing && traceEvents.size() < maxTraceEvents) {
+        traceEvents.push_back({ section, start, end });
+    }
+}
+
+double FrameProfiler::getAverageStepsPerRay() const {
+    uint64_t steps = 0;
+    uint64_t rays = 0;
+    for (int i = 0; i < historyCount; i++) {
+        steps += history[i].ddaSteps;
+        rays += history[i].rays;
+    }
+    return rays > 0 ? static_cast<double>(steps) / rays : 0.0;
+}
+
+bool FrameProfiler::writeCsv(const char* path) const {
+    std::ofstream out(path);
+    if (!out) {
+        return false;
+    }
+
+    out << "frame,frame_ms";
+    for (int s = 0; s < SECTION_COUNT; s++) {
+        out << "," << getSectionName(static_cast<ProfileSection>(s)) << "_ms";
+    }
+    out << ",dda_steps,rays,steps_per_ray\n";
+
+    uint64_t firstFrame = framesRecorded - historyCount;
+    for (int i = 0; i < historyCount; i++) {
+        const FrameRecord& record = history[(historyNext - historyCount + i + HISTORY) % HISTORY];
+        out << (firstFrame + i) << "," << record.frameMs;
+        for (int s = 0; s < SECTION_COUNT; s++) {
+            out << "," << record.sectionMs[s];
+        }
+        double stepsPerRay = record.rays > 0 ? static_cast<double>(record.ddaSteps) / record.rays : 0.0;
+        out << "," << record.ddaSteps << "," << record.rays << "," << stepsPerRay << "\n";
+    }
+    return static_cast<bool>(out);
+}
+
+bool FrameProfiler::writeChromeTrace(const char* path) const {
+    std::ofstream out(path);
+    if (!out) {
+        return false;
+    }
+
+    out << "{\"traceEvents\":[\n";
+    for (size_t i = 0; i < traceEvents.size(); i++) {
+        const TraceEvent& event = traceEvents[i];
+        char line[256];
+        std::snprintf(line, sizeof(line),
+                      "{\"name\":\"%s\",\"ph\":\"X\",\"pid\":0,\"tid\":0,\"ts\":%.3f,\"dur\":%.3f}%s\n",
+                      getSectionName(event.section), toMicroseconds(event.start),
+                      toMicroseconds(event.end) - toMicroseconds(event.start),
+                      i + 1 < traceEvents.size() ? "," : "");
+        out << line;
+    }
+    out << "],\"displayTimeUnit\":\"ms\"}\n";
+    return static_cast<bool>(out);
+}
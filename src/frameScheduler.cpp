@@ -0,0 +1,33 @@
+#include "frameScheduler.h"
+
+void FrameScheduler::setFrameCap(double framesPerSecond) {
+    frameCapSeconds = framesPerSecond > 0.0 ? 1.0 / framesPerSecond : 0.0;
+}
+
+int FrameScheduler::beginFrame() {
+    uint64_t now = SDL_GetPerformanceCounter();
+    if (started) {
+        lastFrameSeconds = static_cast<double>(now - frameStart) / frequency;
+        accumulator += lastFrameSeconds < MAX_CATCH_UP_SECONDS ? lastFrameSeconds : MAX_CATCH_UP_SECONDS;
+    }
+    frameStart = now;
+    started = true;
+
+    int ticks = static_cast<int>(accumulator / tickSeconds);
+    accumulator -= ticks * tickSeconds;
+    return ticks;
+}
+
+void FrameScheduler::endFrame() {
+    if (frameCapSeconds <= 0.0) {
+        return;
+    }
+
+    double remaining = frameCapSeconds - secondsSince(frameStart);
+    if (remaining > SPIN_SECONDS) {
+        SDL_DelayNS(static_cast<uint64_t>((remaining - SPIN_SECONDS) * 1e9));
+    }
+    while (secondsSince(frameStart) < frameCapSeconds) {
+        // Spin for the last stretch, sleeping that close to the deadline overshoots
+    }
+}
@@ -0,0 +1,43 @@
+#include "framebuffer.h"
+
+bool Framebuffer::resize(SDL_Renderer* renderer, int newWidth, int newHeight) {
+    if (texture && newWidth == width && newHeight == height) {
+        return true;
+    }
+    release();
+
+    texture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_XRGB8888,
+                                SDL_TEXTUREACCESS_STREAMING, newWidth, newHeight);
+    if (!texture) {
+        std::cerr << "SDL_CreateTexture failed: " << SDL_GetError() << std::endl;
+        return false;
+    }
+    width = newWidth;
+    height = newHeight;
+    return true;
+}
+
+void Framebuffer::release() {
+    if (texture) {
+        SDL_DestroyTexture(texture);
+        texture = nullptr;
+    }
+    width = 0;
+    height = 0;
+}
+
+bool Framebuffer::lock() {
+    void* mapped = nullptr;
+    int pitchBytes = 0;
+    if (!texture || !SDL_LockTexture(texture, nullptr, &mapped, &pitchBytes)) {
+        return false;
+    }
+    pixels = static_cast<uint32_t*>(mapped);
+    pitch = pitchBytes / static_cast<int>(sizeof(uint32_t));
+    return true;
+}
+
+void Framebuffer::unlock() {
+    SDL_UnlockTexture(texture);
+    pixels = nullptr;
+}
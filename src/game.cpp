@@ -1,103 +1,213 @@
-#pragma once
-
-#include <vector>
-#include <math.h>
-
-class WorldMap {
-private:
-    std::vector<std::vector<int>> mapData;
-    int height;
-    int width;
-    
-public:
-    WorldMap(const std::vector<std::vector<int>>& mapData, int height, int width) 
-        : mapData(mapData), height(height), width(width) {
-        // Validate dimensions match mapData
-        //if (mapData.size() != height || (height > 0 && mapData[0].size() != width)) {
-        //    throw std::invalid_argument("Map dimensions don't match data");
-        //}
-    }
-
-    // Return const reference to avoid copying
-    const std::vector<std::vector<int>>& getMap() const { return mapData; }
-    
-    // Validate bounds before access
-    bool isWall(int x, int y) const { 
-        if (x < 0 || x >= width || y < 0 || y >= height) {
-            return true; // Treat out-of-bounds as walls
+#include "game.h"
+
+void WorldMap::markDirty(CellRect rect) {
+    bool absorbed = true;
+    while (absorbed) {
+        absorbed = false;
+        for (size_t i = 0; i < dirtyRects.size(); i++) {
+            if (dirtyRects[i].touches(rect)) {
+                rect = rect.merged(dirtyRects[i]);
+                dirtyRects[i] = dirtyRects.back();
+                dirtyRects.pop_back();
+                absorbed = true;
+                break;
+            }
         }
-        return mapData[y][x] != 0; 
     }
-    
-    int getWallType(int x, int y) const { 
-        if (x < 0 || x >= width || y < 0 || y >= height) {
-            return 1; // Default wall type
+    dirtyRects.push_back(rect);
+
+    if (dirtyRects.size() > MAX_DIRTY_RECTS) {
+        CellRect all = dirtyRects[0];
+        for (const CellRect& dirty : dirtyRects) {
+            all = all.merged(dirty);
         }
-        return mapData[y][x]; 
-    }
-
-    int getWidth() const { return width; }
-    int getHeight() const { return height; }
-};
-
-class Player {
-private:
-    float x;
-    float y;
-    float angle;
-    float FOV;
-    float moveSpeed;
-    float rotateSpeed;
-    
-    // Add reference to map for collision detection
-    const WorldMap* worldMap;
-
-public:
-    Player(float startX, float startY, float startAngle, float fov, float rotateSpeed = 2.0f) 
-        : x(startX), y(startY), angle(startAngle), FOV(fov), 
-          rotateSpeed(rotateSpeed), moveSpeed(0.2f), worldMap(nullptr) {}
-    
-    // Allow setting world map for collision detection
-    void setWorldMap(const WorldMap* map) { worldMap = map; }
-    
-    // Improved movement with collision detection
-    void moveForward() { 
-        float newX = x + cos(angle) * moveSpeed;
-        float newY = y + sin(angle) * moveSpeed;
-        
-        if (worldMap && !worldMap->isWall(static_cast<int>(newX), static_cast<int>(newY))) {
-            x = newX;
-            y = newY;
+        dirtyRects.assign(1, all);
+    }
+}
+
+WorldMap& WorldMap::assignCells(MapGrid&& cells) {
+    grid = std::move(cells);
+    height = grid.getHeight();
+    width = grid.getWidth();
+
+    // Pending rects may lie outside the new size, and the whole map covers them anyway
+    dirtyRects.clear();
+    CellRect all = { 0, 0, width, height };
+    if (!all.empty()) {
+        dirtyRects.push_back(all);
+    }
+    return *this;
+}
+
+int WorldMap::walkSegment(float ax, float ay, float bx, float by, float& fraction, bool& crossedX) const {
+    int cellX = floor(ax);
+    int cellY = floor(ay);
+    fraction = 0.0f;
+    crossedX = false;
+
+    if (!grid.inBounds(cellX, cellY)) {
+        return SEGMENT_STARTS_OUTSIDE;
+    }
+
+    const uint8_t* cells = grid.data();
+    int cellIndex = grid.index(cellX, cellY);
+    if (cells[cellIndex] != 0) {
+        return cellIndex;
+    }
+
+    float dirX = bx - ax;
+    float dirY = by - ay;
+
+    // Cells left to cross on each axis, clamped to the border ring,
+    // which is solid and always stops the walk before it runs out
+    int endX = std::min(std::max(static_cast<int>(floor(bx)), -MapGrid::BORDER), width);
+    int endY = std::min(std::max(static_cast<int>(floor(by)), -MapGrid::BORDER), height);
+    int stepsX = abs(endX - cellX);
+    int stepsY = abs(endY - cellY);
+
+    float deltaX = abs(1.0f / dirX);
+    float deltaY = abs(1.0f / dirY);
+    int stepX = dirX < 0 ? -1 : 1;
+    int stepY = dirY < 0 ? -1 : 1;
+    float sideX = (dirX < 0 ? ax - cellX : cellX + 1.0f - ax) * deltaX;
+    float sideY = (dirY < 0 ? ay - cellY : cellY + 1.0f - ay) * deltaY;
+    int stride = grid.getStride();
+
+    while (stepsX + stepsY > 0) {
+        if (stepsY == 0 || (stepsX > 0 && sideX < sideY)) {
+            fraction = sideX;
+            sideX += deltaX;
+            cellIndex += stepX;
+            stepsX--;
+            crossedX = true;
+        } else {
+            fraction = sideY;
+            sideY += deltaY;
+            cellIndex += stepY * stride;
+            stepsY--;
+            crossedX = false;
+        }
+        if (cells[cellIndex] != 0) {
+            return cellIndex;
+        }
+    }
+    return SEGMENT_CLEAR;
+}
+
+bool WorldMap::sweepAxis(float& along, float across, float halfSize, float delta,
+               int alongStride, int acrossStride, int alongLimit, int acrossLimit) const {
+    if (delta == 0.0f) {
+        return false;
+    }
+
+    int firstAcross = clampCell(static_cast<int>(floor(across - halfSize)), acrossLimit);
+    int lastAcross = clampCell(static_cast<int>(ceil(across + halfSize)) - 1, acrossLimit);
+    float lead = delta > 0.0f ? along + halfSize : along - halfSize;
+    int step = delta > 0.0f ? 1 : -1;
+    // Cells the leading face is in before and after the move. Moving up the
+    // axis the face is exclusive, so one exactly on a boundary is still in
+    // the cell below and the cell it is entering gets tested
+    int cell;
+    int endCell;
+    if (delta > 0.0f) {
+        cell = clampCell(static_cast<int>(ceil(lead)) - 1, alongLimit);
+        endCell = clampCell(static_cast<int>(ceil(lead + delta)) - 1, alongLimit);
+    } else {
+        cell = clampCell(static_cast<int>(floor(lead)), alongLimit);
+        endCell = clampCell(static_cast<int>(floor(lead + delta)), alongLimit);
+    }
+
+    const uint8_t* origin = grid.data() + grid.index(0, 0);
+    while (cell != endCell) {
+        cell += step;
+        const uint8_t* line = origin + cell * alongStride;
+        for (int a = firstAcross; a <= lastAcross; a++) {
+            if (line[a * acrossStride] != 0) {
+                along = delta > 0.0f ? cell - COLLISION_SKIN - halfSize : cell + 1.0f + COLLISION_SKIN + halfSize;
+                return true;
+            }
         }
     }
-    
-    void moveBackwards() { 
-        float newX = x - cos(angle) * moveSpeed;
-        float newY = y - sin(angle) * moveSpeed;
-        
-        if (worldMap && !worldMap->isWall(static_cast<int>(newX), static_cast<int>(newY))) {
-            x = newX;
-            y = newY;
+    along += delta;
+    return false;
+}
+
+bool WorldMap::setCells(CellRect rect, uint8_t wallType) {
+    rect.x0 = std::max(rect.x0, 0);
+    rect.y0 = std::max(rect.y0, 0);
+    rect.x1 = std::min(rect.x1, width);
+    rect.y1 = std::min(rect.y1, height);
+    if (rect.empty()) {
+        return false;
+    }
+
+    bool changed = false;
+    for (int y = rect.y0; y < rect.y1; y++) {
+        uint8_t* cells = grid.row(y);
+        for (int x = rect.x0; x < rect.x1; x++) {
+            changed |= cells[x] != wallType;
+            cells[x] = wallType;
         }
     }
-    
-    void turnLeft() { angle -= 0.1f * rotateSpeed; }
-    void turnRight() { angle += 0.1f * rotateSpeed; }
-    
-    // Const getters
-    float getX() const { return x; }
-    float getY() const { return y; }
-    float getAngle() const { return angle; }
-    float getFieldOfView() const { return FOV; }
-    
-    // Validated setters
-    void setPosition(float nx, float ny) { 
-        if (worldMap && worldMap->isWall(static_cast<int>(nx), static_cast<int>(ny))) {
-            return; // Don't allow moving into walls
+    if (changed) {
+        markDirty(rect);
+    }
+    return true;
+}
+
+void WorldMap::flushEdits() {
+    for (const CellRect& rect : dirtyRects) {
+        for (MapEditListener* listener : editListeners) {
+            listener->onCellsChanged(grid, rect);
         }
-        x = nx; 
-        y = ny; 
     }
-    
-    void setAngle(float nAngle) { angle = nAngle; }
-};
\ No newline at end of file
+    dirtyRects.clear();
+}
+
+void WorldMap::addEditListener(MapEditListener* listener) {
+    if (std::find(editListeners.begin(), editListeners.end(), listener) == editListeners.end()) {
+        editListeners.push_back(listener);
+    }
+}
+
+void WorldMap::removeEditListener(MapEditListener* listener) {
+    editListeners.erase(std::remove(editListeners.begin(), editListeners.end(), listener), editListeners.end());
+}
+
+bool WorldMap::hasLineOfSight(float ax, float ay, float bx, float by) const {
+    float fraction;
+    bool crossedX;
+    return walkSegment(ax, ay, bx, by, fraction, crossedX) == SEGMENT_CLEAR;
+}
+
+bool WorldMap::findWallOnSegment(float ax, float ay, float bx, float by, SegmentHit& hit) const {
+    float fraction;
+    bool crossedX;
+    int cellIndex = walkSegment(ax, ay, bx, by, fraction, crossedX);
+
+    hit.fraction = cellIndex == SEGMENT_CLEAR ? 1.0f : fraction;
+    hit.x = ax + (bx - ax) * hit.fraction;
+    hit.y = ay + (by - ay) * hit.fraction;
+    hit.hitVerticalWall = crossedX;
+    if (cellIndex == SEGMENT_CLEAR) {
+        hit.wallType = 0;
+        return false;
+    }
+    hit.wallType = cellIndex >= 0 ? grid.data()[cellIndex] : MapGrid::BORDER_WALL;
+    return true;
+}
+
+bool WorldMap::moveBox(float& x, float& y, float halfSize, float dx, float dy) const {
+    float longest = std::max(fabs(dx), fabs(dy));
+    int steps = std::max(1, static_cast<int>(ceil(longest / MAX_SUBSTEP)));
+    float stepX = dx / steps;
+    float stepY = dy / steps;
+    int stride = grid.getStride();
+
+    bool blocked = false;
+    for (int i = 0; i < steps; i++) {
+        blocked |= sweepAxis(x, y, halfSize, stepX, 1, stride, width, height);
+        blocked |= sweepAxis(y, x, halfSize, stepY, stride, 1, height, width);
+    }
+    return blocked;
+}
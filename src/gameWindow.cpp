@@ -1,178 +1,252 @@
-#include <SDL3/SDL.h>
-#include <iostream>
-#include <vector>
-
-#include "game.cpp"
-#include "raycaster.cpp"
-
-struct Color {
-    unsigned char r;
-    unsigned char g;
-    unsigned char b;
-    unsigned char a;
-    
-    // Constructor with default alpha = 255 (fully opaque)
-    Color(unsigned char red = 0, unsigned char green = 0, unsigned char blue = 0, unsigned char alpha = 255)
-        : r(red), g(green), b(blue), a(alpha) {}
-};
-
-//Not finished at all
-class GameView {
-private:
-    int rayWidth;
-
-    void drawRays(SDL_Renderer* renderer, float rayWidth, std::vector<RayHit> rayResults, float screenHeight, float screenWidth) {
-        for (size_t i = 0; i < rayResults.size(); i++) {
-            const auto& ray = rayResults[i];
-
-            // Scale factor to adjust wall height perception
-            float wallHeight = (ray.distance > 0.01f) ? (360.0f / ray.distance) : screenHeight;
-
-            // Cap the wall height to screen height
-            if (wallHeight > screenHeight) wallHeight = screenHeight;
-
-            // Calculate top and bottom of the wall slice
-            float wallTop = (screenHeight - wallHeight) / 2.0f;
-            
-            Color wallColor(100, 100, 100, 255);
-            
-            switch(ray.wallType) {
-                case 1:
-                    wallColor = Color(255, 0, 0, 255);
-                    break;
-                case 2:
-                    wallColor = Color(255, 255, 0, 255);
-                    break;
-            }
-
-            // Draw each ray as a 1-pixel wide vertical line
-            SDL_FRect rect = { (float)i, wallTop, 1.0f, wallHeight };
-            SDL_SetRenderDrawColor(renderer, wallColor.r, wallColor.g, wallColor.b, wallColor.a);
-            SDL_RenderFillRect(renderer, &rect);
+#include "gameWindow.h"
+
+void GameView::drawRays(SDL_Renderer* renderer, float rayWidth, const std::vector<RayHit>& rayResults, float screenHeight) {
+    for (size_t i = 0; i < rayResults.size(); i++) {
+        const auto& ray = rayResults[i];
+
+        // Out of range, nothing to draw over the backdrop
+        if (ray.wallType == 0) {
+            continue;
         }
-    }
 
-    void drawFloor(SDL_Renderer* renderer, float windowHeight, float windowWidth) {
-        SDL_FRect rect = { 0, 0, windowWidth, windowHeight };
-        SDL_SetRenderDrawColor(renderer, 0, 0, 100, 255);
+        float wallHeight = getWallHeight(ray, screenHeight);
+
+        // Calculate top and bottom of the wall slice
+        float wallTop = (screenHeight - wallHeight) / 2.0f;
+        
+        Color wallColor = getWallColor(ray.wallType);
+
+        SDL_FRect rect = { i * rayWidth, wallTop, rayWidth, wallHeight };
+        SDL_SetRenderDrawColor(renderer, wallColor.r, wallColor.g, wallColor.b, wallColor.a);
         SDL_RenderFillRect(renderer, &rect);
     }
-
-public:
-    void render(SDL_Renderer* renderer, float rayWidth, std::vector<RayHit> rayResults, float screenHeight, float screenWidth) {
-        drawFloor(renderer, screenHeight, screenWidth);
-        drawRays(renderer, rayWidth, rayResults, screenHeight, screenWidth);
+}
+
+void GameView::drawFloor(SDL_Renderer* renderer, float windowHeight, float windowWidth) {
+    SDL_FRect rect = { 0, 0, windowWidth, windowHeight };
+    SDL_SetRenderDrawColor(renderer, floorColor.r, floorColor.g, floorColor.b, floorColor.a);
+    SDL_RenderFillRect(renderer, &rect);
+}
+
+void GameView::drawFrame(const Player& player, const std::vector<RayHit>& rayResults, int screenHeight, int screenWidth) {
+    if (texturedFloors) {
+        floorCaster.draw(framebuffer.row(0), framebuffer.getPitch(), screenWidth, screenHeight, player.getX(),
+                         player.getY(), player.getAngle(), player.getFieldOfView(), projectionScale);
+    } else {
+        int horizon = screenHeight / 2;
+        framebuffer.fillRows(0, horizon, Framebuffer::packColor(ceilingColor.r, ceilingColor.g, ceilingColor.b));
+        framebuffer.fillRows(horizon, screenHeight, Framebuffer::packColor(floorColor.r, floorColor.g, floorColor.b));
     }
-}; 
 
+    int columns = std::min(static_cast<int>(rayResults.size()), screenWidth);
+    columnDepths.resize(columns);
+    for (int x = 0; x < columns; x++) {
+        const RayHit& ray = rayResults[x];
+        columnDepths[x] = ray.distance;
 
-class GameWindow {
-private:
-    SDL_Window* window;
-    SDL_Renderer* renderer;
-    GameView gameView;
-    bool running;
-    int windowWidth;
-    int windowHeight;
-    int FOV;
-    float rayWidth;
-
-    void cleanup() {
-        if (renderer) {
-            SDL_DestroyRenderer(renderer);
-            renderer = nullptr;
+        // Rays that ran out of range hit nothing, the floor and ceiling show through
+        if (ray.wallType == 0) {
+            continue;
         }
-        if (window) {
-            SDL_DestroyWindow(window);
-            window = nullptr;
+        if (texturedWalls) {
+            drawTexturedColumn(x, ray, screenHeight);
+            continue;
         }
-        SDL_Quit();
-    }
 
-    void handleEvents(Player& player) {
-        const bool *keys = SDL_GetKeyboardState(NULL);
+        float wallHeight = getWallHeight(ray, screenHeight);
+        float wallTop = (screenHeight - wallHeight) / 2.0f;
 
-        if (keys[SDL_SCANCODE_ESCAPE]) {
-            running = false;
-        }
+        int firstRow = static_cast<int>(wallTop + 0.5f);
+        int endRow = static_cast<int>(wallTop + wallHeight + 0.5f);
 
-        if (keys[SDL_SCANCODE_W] || keys[SDL_SCANCODE_UP]) {
-            player.moveForward();
-        }
-        if (keys[SDL_SCANCODE_S] || keys[SDL_SCANCODE_DOWN]) {
-            player.moveBackwards();
-        }
-        if (keys[SDL_SCANCODE_A] || keys[SDL_SCANCODE_LEFT]) {
-            player.turnLeft();
-        }
-        if (keys[SDL_SCANCODE_D] || keys[SDL_SCANCODE_RIGHT]) {
-            player.turnRight();
+        Color wallColor = getWallColor(ray.wallType);
+        framebuffer.fillColumn(x, firstRow, endRow, Framebuffer::packColor(wallColor.r, wallColor.g, wallColor.b));
+    }
+
+    if (sprites && sprites->size() > 0) {
+        spriteRenderer.draw(framebuffer.row(0), framebuffer.getPitch(), columns, screenHeight, columnDepths.data(),
+                            *sprites, player.getX(), player.getY(), player.getAngle(), player.getFieldOfView(),
+                            projectionScale);
+    }
+}
+
+void GameView::drawTexturedColumn(int x, const RayHit& ray, int screenHeight) {
+    // V is mapped over the unclipped slice so close walls show their middle, not a squashed texture
+    float lineHeight = getProjectedHeight(ray, screenHeight);
+    float wallTop = (screenHeight - lineHeight) / 2.0f;
+
+    int firstRow = std::max(static_cast<int>(wallTop + 0.5f), 0);
+    int endRow = std::min(static_cast<int>(wallTop + lineHeight + 0.5f), screenHeight);
+
+    float u = WallTextureAtlas::wallU(ray.hitX, ray.hitY, ray.hitVerticalWall, ray.rayDirX, ray.rayDirY);
+    wallTextures.drawColumn(framebuffer.row(0) + x, framebuffer.getPitch(), firstRow, endRow,
+                            wallTop, lineHeight, ray.wallType, u);
+}
+
+bool GameView::renderFramebuffer(SDL_Renderer* renderer, const Player& player, const std::vector<RayHit>& rayResults,
+                       float screenHeight, float screenWidth) {
+    if (!framebuffer.resize(renderer, static_cast<int>(screenWidth), static_cast<int>(screenHeight)) ||
+        !framebuffer.lock()) {
+        return false;
+    }
+    drawFrame(player, rayResults, framebuffer.getHeight(), framebuffer.getWidth());
+    framebuffer.unlock();
+    framebuffer.present(renderer);
+    return true;
+}
+
+void GameView::render(SDL_Renderer* renderer, const Player& player, float rayWidth, int rowHeight,
+            const std::vector<RayHit>& rayResults, float screenHeight, float screenWidth) {
+    float focalLength = focalLengthFor(player.getFieldOfView(), screenWidth);
+
+    // Falls back to draw calls if the streaming texture can't be used
+    if (renderMode == RenderMode::FRAMEBUFFER) {
+        int renderWidth = std::max(static_cast<int>(rayResults.size()), 1);
+        int renderHeight = std::max(static_cast<int>(screenHeight) / std::max(rowHeight, 1), 1);
+        projectionScale = focalLength * renderHeight / screenHeight;
+        if (renderFramebuffer(renderer, player, rayResults, renderHeight, renderWidth)) {
+            return;
         }
     }
+    projectionScale = focalLength;
+    drawFloor(renderer, screenHeight, screenWidth);
+    drawRays(renderer, rayWidth, rayResults, screenHeight);
+}
+
+void GameWindow::drawProfilerOverlay() {
+    const float lineHeight = 10.0f;
+    float y = 8.0f;
+    char line[128];
+
+    SDL_SetRenderDrawColor(renderer, 255, 255, 255, 255);
+
+    FrameProfiler::Stats frame = profiler->getFrameStats();
+    std::snprintf(line, sizeof(line), "%-14s min %6.2f  avg %6.2f  p99 %6.2f ms", "frame", frame.minMs, frame.avgMs, frame.p99Ms);
+    SDL_RenderDebugText(renderer, 8.0f, y, line);
+    y += lineHeight;
+
+    for (int s = 0; s < FrameProfiler::SECTION_COUNT; s++) {
+        ProfileSection section = static_cast<ProfileSection>(s);
+        FrameProfiler::Stats stats = profiler->getSectionStats(section);
+        std::snprintf(line, sizeof(line), "%-14s min %6.2f  avg %6.2f  p99 %6.2f ms",
+                      FrameProfiler::getSectionName(section), stats.minMs, stats.avgMs, stats.p99Ms);
+        SDL_RenderDebugText(renderer, 8.0f, y, line);
+        y += lineHeight;
+    }
 
-public:
-    GameWindow(int width = 1280, int height = 720, int fov = 120)
-        : window(nullptr), renderer(nullptr),
-          running(false), windowWidth(width), windowHeight(height), FOV(fov) {}
+    std::snprintf(line, sizeof(line), "dda steps %llu  steps/ray %.2f",
+                  static_cast<unsigned long long>(profiler->getLastDdaSteps()), profiler->getAverageStepsPerRay());
+    SDL_RenderDebugText(renderer, 8.0f, y, line);
+}
 
-    ~GameWindow() {
-        cleanup();
+void GameWindow::drawMinimapOverlay(const Player& player, const std::vector<RayHit>& rayResults) {
+    if (minimap->getPixelWidth() <= 0 || minimap->getPixelHeight() <= 0) {
+        return;
     }
-
-    bool isRunning() {
-        return running;
+    const float margin = 8.0f;
+    float height = windowHeight / 3.0f;
+    float width = height * minimap->getPixelWidth() / minimap->getPixelHeight();
+    SDL_FRect area = { windowWidth - width - margin, margin, width, height };
+
+    SDL_SetRenderDrawColor(renderer, 50, 50, 50, 255);
+    SDL_RenderFillRect(renderer, &area);
+    minimap->render(renderer, player, rayResults, area);
+}
+
+void GameWindow::cleanup() {
+    gameView.releaseResources();
+    if (minimap) {
+        minimap->releaseResources();
+    }
+    if (renderer) {
+        SDL_DestroyRenderer(renderer);
+        renderer = nullptr;
+    }
+    if (window) {
+        SDL_DestroyWindow(window);
+        window = nullptr;
     }
+}
 
-    bool init() {
-        // Initialize SDL
-        if (!SDL_Init(SDL_INIT_VIDEO)) {
-            std::cerr << "SDL_Init failed: " << SDL_GetError() << std::endl;
-            return false;
-        }
+uint32_t GameWindow::readKeys() {
+    const bool *keys = SDL_GetKeyboardState(NULL);
 
-        // Create window
-        window = SDL_CreateWindow(
-            "Game Window",
-            windowWidth, windowHeight,
-            0
-        );
-        if (!window) {
-            std::cerr << "SDL_CreateWindow failed: " << SDL_GetError() << std::endl;
-            SDL_Quit();
-            return false;
-        }
+    // F3 toggles the profiler overlay
+    if (keys[SDL_SCANCODE_F3] && !overlayKeyWasDown) {
+        showProfilerOverlay = !showProfilerOverlay;
+    }
+    overlayKeyWasDown = keys[SDL_SCANCODE_F3];
 
-        // Create renderer
-        renderer = SDL_CreateRenderer(window, nullptr);
-        if (!renderer) {
-            std::cerr << "SDL_CreateRenderer failed: " << SDL_GetError() << std::endl;
-            SDL_DestroyWindow(window);
-            SDL_Quit();
-            return false;
-        }
-        return true;
+    uint32_t heldKeys = 0;
+    if (keys[SDL_SCANCODE_W] || keys[SDL_SCANCODE_UP]) {
+        heldKeys |= INPUT_FORWARD;
+    }
+    if (keys[SDL_SCANCODE_S] || keys[SDL_SCANCODE_DOWN]) {
+        heldKeys |= INPUT_BACKWARDS;
+    }
+    if (keys[SDL_SCANCODE_A] || keys[SDL_SCANCODE_LEFT]) {
+        heldKeys |= INPUT_TURN_LEFT;
+    }
+    if (keys[SDL_SCANCODE_D] || keys[SDL_SCANCODE_RIGHT]) {
+        heldKeys |= INPUT_TURN_RIGHT;
+    }
+    return heldKeys;
+}
+
+bool GameWindow::init() {
+    window = SDL_CreateWindow(
+        "Game Window",
+        windowWidth, windowHeight,
+        0
+    );
+    if (!window) {
+        std::cerr << "SDL_CreateWindow failed: " << SDL_GetError() << std::endl;
+        return false;
     }
 
-    void initRun() {
-        running = true;
+    renderer = SDL_CreateRenderer(window, nullptr);
+    if (!renderer) {
+        std::cerr << "SDL_CreateRenderer failed: " << SDL_GetError() << std::endl;
+        SDL_DestroyWindow(window);
+        window = nullptr;
+        return false;
+    }
+    return true;
+}
 
-        rayWidth = 1.0f;
+void GameWindow::setMinimap(Minimap* map) {
+    if (minimap && minimap != map) {
+        minimap->releaseResources();
     }
+    minimap = map;
+}
 
-    void update(Player& player, std::vector<RayHit> rayResults) {
-        // Handle events
-        handleEvents(player);
+void GameWindow::update(const Player& player, const std::vector<RayHit>& rayResults) {
+    // Clear the screen
+    SDL_SetRenderDrawColor(renderer, 50, 50, 50, 255);
+    SDL_RenderClear(renderer);
+    
+    // Render content
+    {
+        ScopedTimer timer(profiler, ProfileSection::GAME_RENDER);
+        gameView.render(renderer, player, rayWidth, rowHeight, rayResults, windowHeight, windowWidth);
+    }
 
-        // Clear the screen
-        SDL_SetRenderDrawColor(renderer, 50, 50, 50, 255);
-        SDL_RenderClear(renderer);
-        
-        // Render content
-        gameView.render(renderer, rayWidth, rayResults, windowHeight, windowWidth);
-        
-        // Present to screen
-        SDL_RenderPresent(renderer);
+    if (minimap) {
+        drawMinimapOverlay(player, rayResults);
+    }
 
-        SDL_Delay(16);
+    if (profiler && showProfilerOverlay) {
+        drawProfilerOverlay();
+    }
+    
+    // Present to screen
+    ScopedTimer timer(profiler, ProfileSection::PRESENT);
+    SDL_RenderPresent(renderer);
+}
+
+void GameWindow::setVSync(bool enabled) {
+    if (renderer) {
+        SDL_SetRenderVSync(renderer, enabled ? 1 : 0);
     }
-};
\ No newline at end of file
+}
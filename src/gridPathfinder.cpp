@@ -0,0 +1,182 @@
+#include "gridPathfinder.h"
+
+void GridPathfinder::beginSearch(int goal) {
+    const MapGrid& grid = worldMap.getGrid();
+    cells = grid.data();
+    stride = grid.getStride();
+    if (costs.size() != grid.getByteSize()) {
+        costs.assign(grid.getByteSize(), 0.0f);
+        parents.assign(grid.getByteSize(), -1);
+        seenSearch.assign(grid.getByteSize(), 0);
+        closedSearch.assign(grid.getByteSize(), 0);
+        search = 0;
+    }
+    if (++search == 0) {
+        std::fill(seenSearch.begin(), seenSearch.end(), 0);
+        std::fill(closedSearch.begin(), closedSearch.end(), 0);
+        search = 1;
+    }
+    openList.clear();
+    goalCell = goal;
+    goalX = cellX(goal);
+    goalY = cellY(goal);
+    lastExpanded = 0;
+    lastCost = 0.0f;
+}
+
+void GridPathfinder::pushNode(int cell, float cost, int parent) {
+    if (closedSearch[cell] == search || (seenSearch[cell] == search && costs[cell] <= cost)) {
+        return;
+    }
+    seenSearch[cell] = search;
+    costs[cell] = cost;
+    parents[cell] = parent;
+    openList.push_back({ cost + octile(cellX(cell) - goalX, cellY(cell) - goalY), cost, cell });
+    std::push_heap(openList.begin(), openList.end());
+}
+
+int GridPathfinder::popNode() {
+    while (!openList.empty()) {
+        std::pop_heap(openList.begin(), openList.end());
+        OpenNode node = openList.back();
+        openList.pop_back();
+        // Stale entries are left in the heap when a cheaper route is found
+        if (closedSearch[node.cell] == search || node.cost > costs[node.cell]) {
+            continue;
+        }
+        closedSearch[node.cell] = search;
+        lastExpanded++;
+        return node.cell;
+    }
+    return -1;
+}
+
+void GridPathfinder::expandNeighbours(int cell) {
+    for (int dy = -1; dy <= 1; dy++) {
+        for (int dx = -1; dx <= 1; dx++) {
+            if ((dx != 0 || dy != 0) && canStep(cell, dx, dy)) {
+                pushNode(cell + dx + dy * stride, costs[cell] + (dx != 0 && dy != 0 ? DIAGONAL_COST : 1.0f), cell);
+            }
+        }
+    }
+}
+
+int GridPathfinder::jump(int cell, int dx, int dy) const {
+    int step = dx + dy * stride;
+    while (true) {
+        if (!canStep(cell, dx, dy)) {
+            return -1;
+        }
+        cell += step;
+        if (cell == goalCell) {
+            return cell;
+        }
+
+        if (dx != 0 && dy != 0) {
+            if (jump(cell, dx, 0) >= 0 || jump(cell, 0, dy) >= 0) {
+                return cell;
+            }
+        } else if (dx != 0) {
+            // An open cell beside us that was walled behind us is a forced neighbour
+            if ((isOpen(cell - stride) && !isOpen(cell - dx - stride)) ||
+                (isOpen(cell + stride) && !isOpen(cell - dx + stride))) {
+                return cell;
+            }
+        } else {
+            if ((isOpen(cell - 1) && !isOpen(cell - 1 - dy * stride)) ||
+                (isOpen(cell + 1) && !isOpen(cell + 1 - dy * stride))) {
+                return cell;
+            }
+        }
+    }
+}
+
+void GridPathfinder::pushJump(int cell, int dx, int dy) {
+    int jumpPoint = jump(cell, dx, dy);
+    if (jumpPoint >= 0) {
+        pushNode(jumpPoint, costs[cell] + distanceBetween(cell, jumpPoint), cell);
+    }
+}
+
+void GridPathfinder::expandJumpPoints(int cell) {
+    int parent = parents[cell];
+    if (parent < 0) {
+        for (int dy = -1; dy <= 1; dy++) {
+            for (int dx = -1; dx <= 1; dx++) {
+                if (dx != 0 || dy != 0) {
+                    pushJump(cell, dx, dy);
+                }
+            }
+        }
+        return;
+    }
+
+    int moveX = cellX(cell) - cellX(parent);
+    int moveY = cellY(cell) - cellY(parent);
+    int dx = (moveX > 0) - (moveX < 0);
+    int dy = (moveY > 0) - (moveY < 0);
+
+    if (dx != 0 && dy != 0) {
+        pushJump(cell, dx, 0);
+        pushJump(cell, 0, dy);
+        pushJump(cell, dx, dy);
+    } else if (dx != 0) {
+        pushJump(cell, dx, 0);
+        pushJump(cell, dx, 1);
+        pushJump(cell, dx, -1);
+        pushJump(cell, 0, 1);
+        pushJump(cell, 0, -1);
+    } else {
+        pushJump(cell, 0, dy);
+        pushJump(cell, 1, dy);
+        pushJump(cell, -1, dy);
+        pushJump(cell, 1, 0);
+        pushJump(cell, -1, 0);
+    }
+}
+
+void GridPathfinder::buildPath(std::vector<int>& path) const {
+    path.clear();
+    for (int cell = goalCell; cell >= 0; cell = parents[cell]) {
+        path.push_back(cell);
+        int parent = parents[cell];
+        if (parent < 0) {
+            break;
+        }
+        int moveX = cellX(parent) - cellX(cell);
+        int moveY = cellY(parent) - cellY(cell);
+        int step = ((moveX > 0) - (moveX < 0)) + ((moveY > 0) - (moveY < 0)) * stride;
+        for (int between = cell + step; between != parent; between += step) {
+            path.push_back(between);
+        }
+    }
+    std::reverse(path.begin(), path.end());
+}
+
+bool GridPathfinder::findPath(int startX, int startY, int endX, int endY, std::vector<int>& path,
+              PathAlgorithm algorithm) {
+    path.clear();
+    const MapGrid& grid = worldMap.getGrid();
+    if (!grid.inBounds(startX, startY) || !grid.inBounds(endX, endY) ||
+        grid.at(startX, startY) != 0 || grid.at(endX, endY) != 0) {
+        return false;
+    }
+
+    beginSearch(grid.index(endX, endY));
+    pushNode(grid.index(startX, startY), 0.0f, -1);
+
+    int cell;
+    while ((cell = popNode()) >= 0) {
+        if (cell == goalCell) {
+            lastCost = costs[cell];
+            buildPath(path);
+            return true;
+        }
+        if (algorithm == PathAlgorithm::JUMP_POINT) {
+            expandJumpPoints(cell);
+        } else {
+            expandNeighbours(cell);
+        }
+    }
+    return false;
+}
@@ -1,11 +1,21 @@
-#pragma once
-
-#include "raycaster.cpp"
-#include "mapWindow.cpp"
-#include "gameWindow.cpp"
+#include "raycaster.h"
+#include "displayManager.h"
+#include "mapWindow.h"
+#include "gameWindow.h"
+#include "frameScheduler.h"
+#include "chunkedWorld.h"
+#include "resolutionController.h"
+#include "framePipeline.h"
+#include "mazeFile.h"
 
 #include "depthFirstMazeGenerator.h"
 #include "recursiveDivisionMazeGenerator.h"
+#include "allocationCounter.h"
+
+#include <cassert>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
 
 // Main Game Loop
 int main() {
@@ -15,13 +25,34 @@ int main() {
     int width = 63;
     int seed = 0;
 
-    DepthFirstMazeGenerator dfGen(width, height, seed);
-    dfGen.generateMaze();
-    
-    RecursiveDivisionMazeGenerator rdGen(width, height, seed);
-    rdGen.generateMaze();
+    // Set RAYCASTER_CHUNKED_WORLD to a seed to stream an unbounded maze in
+    // chunks instead of generating the fixed maze
+    const char* chunkedWorldSeed = std::getenv("RAYCASTER_CHUNKED_WORLD");
+    std::unique_ptr<ChunkedWorld> chunkedWorld;
+    std::vector<std::vector<int>> map;
+
+    // Set RAYCASTER_MAZE_FILE to load a binary maze file instead of generating one
+    const char* mazeFilePath = std::getenv("RAYCASTER_MAZE_FILE");
+    MapGrid loadedGrid;
+    bool mazeLoaded = false;
+
+    if (chunkedWorldSeed) {
+        chunkedWorld.reset(new ChunkedWorld(static_cast<unsigned int>(std::strtoul(chunkedWorldSeed, nullptr, 10))));
+        height = chunkedWorld->getWorldMap().getHeight();
+        width = chunkedWorld->getWorldMap().getWidth();
+    } else if (mazeFilePath && loadMazeFile(mazeFilePath, loadedGrid)) {
+        mazeLoaded = true;
+        height = loadedGrid.getHeight();
+        width = loadedGrid.getWidth();
+    } else {
+        DepthFirstMazeGenerator dfGen(width, height, seed);
+        dfGen.generateMaze();
 
-    std::vector<std::vector<int>> map = dfGen.getMaze();
+        RecursiveDivisionMazeGenerator rdGen(width, height, seed);
+        rdGen.generateMaze();
+
+        map = dfGen.getMaze();
+    }
     // End Maze Init
 
 
@@ -37,20 +68,61 @@ int main() {
     // End Player Init
 
     // Start MiniMap Init
-    WorldMap worldMap(map, height, width);
+    WorldMap fixedMap = mazeLoaded ? WorldMap(std::move(loadedGrid))
+                                   : WorldMap(map, map.empty() ? 0 : height, map.empty() ? 0 : width);
+    const WorldMap& worldMap = chunkedWorld ? chunkedWorld->getWorldMap() : fixedMap;
 
     std::cout << worldMap.getHeight() << std::endl;
     std::cout << worldMap.isWall(0, 0) << std::endl;
 
-    MapWindow mapView((height*9)-1, (width*9)-1);
+    player.setWorldMap(&worldMap);
 
-    p[layer.setWorldMap(&worldMap);
+    // Set RAYCASTER_SPRITES to a count to scatter that many pickups and NPCs
+    // over the open cells. Not with a chunked world, which moves the cells under them
+    SpritePool sprites;
+    const char* spriteCountSetting = std::getenv("RAYCASTER_SPRITES");
+    if (spriteCountSetting && !chunkedWorld) {
+        int spriteCount = std::atoi(spriteCountSetting);
+        RandomNumberGenerator spriteRng(static_cast<uint64_t>(seed), RandomEngine::XOSHIRO256);
+        for (int attempt = 0; sprites.size() < spriteCount && attempt < spriteCount * 16; attempt++) {
+            int cellX = spriteRng.randomInt(0, worldMap.getWidth() - 1);
+            int cellY = spriteRng.randomInt(0, worldMap.getHeight() - 1);
+            if (worldMap.isWall(cellX, cellY)) {
+                continue;
+            }
+            uint8_t type = static_cast<uint8_t>(spriteRng.randomInt(0, SPRITE_TYPE_COUNT - 1));
+            float scale = type == SPRITE_NPC ? 0.8f : 0.4f;
+            sprites.add(cellX + 0.25f + 0.5f * (spriteRng.next32() / 4294967296.0f),
+                        cellY + 0.25f + 0.5f * (spriteRng.next32() / 4294967296.0f), type, scale);
+        }
+    }
 
-    if (!mapView.init()) {
+    // One SDL init and event pump for every window, quit after they are all gone
+    DisplayManager display;
+    if (!display.init()) {
         return 1;
     }
 
-    mapView.initRun(worldMap);
+    // Drawn over the game view by default. Set RAYCASTER_MINIMAP to
+    // "window" for a second window or "off" for none
+    const char* minimapSetting = std::getenv("RAYCASTER_MINIMAP");
+    MinimapMode minimapMode = MinimapMode::OVERLAY;
+    if (minimapSetting && std::strcmp(minimapSetting, "window") == 0) {
+        minimapMode = MinimapMode::WINDOW;
+    } else if (minimapSetting && std::strcmp(minimapSetting, "off") == 0) {
+        minimapMode = MinimapMode::OFF;
+    }
+
+    Minimap minimap;
+    minimap.copyMap(worldMap.getGrid());
+
+    MapWindow mapView((height*9)-1, (width*9)-1);
+    if (minimapMode == MinimapMode::WINDOW) {
+        if (!mapView.init()) {
+            return 1;
+        }
+        mapView.initRun(&minimap);
+    }
     // End MiniMap Init
 
     // Start GameView Init
@@ -61,22 +133,156 @@ int main() {
     }
 
     gameView.initRun();
+    if (minimapMode == MinimapMode::OVERLAY) {
+        gameView.setMinimap(&minimap);
+    }
+    gameView.setSprites(&sprites);
+    display.setWindows(gameView.getWindowID(), mapView.getWindowID());
+
+    // FRAMEBUFFER draws on the CPU and uploads one texture, DRAW_CALLS issues a rect per column
+    gameView.setRenderMode(RenderMode::FRAMEBUFFER);
+
+    // Simulation runs at a fixed tick rate, rendering is uncapped unless vsync or a cap is set
+    double tickRate = 60.0;
+    double frameCap = 0.0;
+    bool vsync = false;
+    gameView.setVSync(vsync);
+    FrameScheduler scheduler(tickRate, frameCap);
+
+    // Casts fewer columns and renders fewer rows when frames run over this budget
+    ResolutionController resolution(1000.0 / 60.0);
     // End GameView Init
 
+    // Start Profiler Init
+    // Overlay is toggled with F3. Set RAYCASTER_PROFILE_CSV and/or
+    // RAYCASTER_PROFILE_TRACE to a path to dump frame stats on exit
+    FrameProfiler profiler;
+    const char* profileCsvPath = std::getenv("RAYCASTER_PROFILE_CSV");
+    const char* profileTracePath = std::getenv("RAYCASTER_PROFILE_TRACE");
+    if (profileTracePath) {
+        profiler.enableTracing(1 << 20);
+    }
+    display.setProfiler(&profiler);
+    gameView.setProfiler(&profiler);
+    mapView.setProfiler(&profiler);
+    minimap.setProfiler(&profiler);
+    // End Profiler Init
+
     // Start Raycaster Init
     Raycaster raycaster(worldMap);
 
-    raycaster.setMaxDistance(6.0);
+    // Far enough that whole corridors show; rays that run out draw as background
+    raycaster.setMaxDistance(64.0f);
+
+    // Long rays jump through open space. A chunked world rewrites its map
+    // on every re-centre, so only a fixed map keeps a field
+    DistanceField distanceField;
+    if (!chunkedWorld) {
+        distanceField.build(fixedMap.getGrid());
+        raycaster.setDistanceField(&distanceField);
+    }
+
+    // Columns are cast in parallel, 0 = one thread per hardware thread, 1 = single threaded
+    int castThreads = 0;
+    ThreadPool castPool(castThreads);
+    raycaster.setThreadPool(&castPool);
+    gameView.setThreadPool(&castPool);
+
+    // Standing still or turning in place reuses the previous frame's rays
+    raycaster.setRayCacheEnabled(true);
     // End Raycaster Init
 
+    // Ticks and casting write into a triple buffer of frames, the views draw
+    // the newest one. Set RAYCASTER_PIPELINED to run them on their own thread,
+    // casting the next frame while this one draws and presents. Not with a
+    // chunked world, whose re-centring rewrites the map the main loop copies
+    // into the minimap
+    FramePipeline pipeline(raycaster, player, tickRate, static_cast<int>(screenWidth), chunkedWorld.get());
+
+    // setCell edits to a fixed map, such as doors and broken walls, reach
+    // the distance field, the cached rays and the minimap texture after the
+    // ticks that made them
+    if (!chunkedWorld) {
+        fixedMap.addEditListener(&distanceField);
+        fixedMap.addEditListener(&raycaster);
+        if (minimapMode != MinimapMode::OFF) {
+            fixedMap.addEditListener(&minimap);
+        }
+        pipeline.setEditedMap(&fixedMap);
+    }
+    std::unique_ptr<ThreadPool> renderPool;
+    if (std::getenv("RAYCASTER_PIPELINED") && !chunkedWorld) {
+        // The cast pool now belongs to the simulation thread
+        renderPool.reset(new ThreadPool(castThreads));
+        gameView.setThreadPool(renderPool.get());
+        pipeline.start();
+    }
+
+    // Debug builds check that frames stop allocating once every buffer exists
+    const int allocationWarmupFrames = 3;
+    int frameNumber = 0;
+    int drawnColumnWidth = 0;
+    int drawnRowHeight = 0;
+    uint64_t drawnMapVersion = 0;
+
     // Main Loop
-    while (mapView.isRunning() || gameView.isRunning())
+    while (display.isRunning())
     {
-        std::vector<RayHit> rayResults = raycaster.castAllRays(player, screenWidth); 
+        uint64_t allocationsBefore = getHeapAllocationCount();
+        profiler.beginFrame();
 
-        gameView.update(player, rayResults);
-        mapView.update(player, rayResults);
+        // Ticks run in the pipeline, this scheduler only applies the frame cap
+        scheduler.beginFrame();
+        display.pumpEvents();
+        if (display.takeMapWindowCloseRequest()) {
+            mapView.close();
+        }
+        pipeline.setInput(gameView.pollInput());
+        pipeline.setResolution(resolution.getColumnWidth(), resolution.getRowHeight());
+        if (!pipeline.isThreaded()) {
+            pipeline.simulateFrame();
+        }
+        pipeline.acquireFrame();
+        const RenderFrame& frame = pipeline.getFrame();
 
+        profiler.addSample(ProfileSection::RAY_CASTING, frame.castStart, frame.castEnd);
+        profiler.setRayStats(frame.ddaSteps, static_cast<int>(frame.rays.size()));
+        if (frame.mapVersion != drawnMapVersion) {
+            // Only a chunked world re-centres, and it never runs pipelined,
+            // so this thread is the one that rewrote the map
+            minimap.copyMap(worldMap.getGrid());
+            drawnMapVersion = frame.mapVersion;
+        }
+
+        // A new resolution recreates the framebuffer texture on the frame it is first drawn
+        bool resolutionChanged = frame.columnWidth != drawnColumnWidth || frame.rowHeight != drawnRowHeight;
+        drawnColumnWidth = frame.columnWidth;
+        drawnRowHeight = frame.rowHeight;
+        gameView.setResolution(frame.columnWidth, frame.rowHeight);
+
+        gameView.update(frame.player, frame.rays);
+        mapView.update(frame.player, frame.rays);
+
+        profiler.endFrame();
+        scheduler.endFrame();
+
+        // Time spent waiting on vsync in present isn't work a lower resolution would save
+        resolution.update(profiler.getLastFrameMs() - profiler.getLastSectionMs(ProfileSection::PRESENT));
+
+        // Chunk streaming allocates chunks on its own thread by design
+        frameNumber++;
+        assert((chunkedWorld || resolutionChanged || frameNumber <= allocationWarmupFrames
+                || getHeapAllocationCount() == allocationsBefore)
+               && "steady-state frame allocated on the heap");
+    }
+
+    pipeline.stop();
+
+    if (profileCsvPath && !profiler.writeCsv(profileCsvPath)) {
+        std::cerr << "Could not write profile CSV to " << profileCsvPath << std::endl;
+    }
+    if (profileTracePath && !profiler.writeChromeTrace(profileTracePath)) {
+        std::cerr << "Could not write profile trace to " << profileTracePath << std::endl;
     }
     
     return 0;
@@ -1,205 +1,239 @@
-#include <SDL3/SDL.h>
-#include <iostream>
-#include <vector>
+#include "mapWindow.h"
 
-#include "raycaster.cpp"
-#include "game.cpp"
-
-
-class PlayerView {
-private:
-    void drawPlayer(SDL_Renderer* renderer, const Player& player) {
-        SDL_SetRenderDrawColor(renderer, 255, 0, 0, 255);
-
-        int playerPX = (player.getX() * 9);
-        int playerPY = (player.getY() * 9);
-
-        SDL_RenderPoint(renderer, playerPX / 9, playerPY / 9);
-        SDL_FRect rect = { playerPX, playerPY, 3, 3 };
-        SDL_RenderFillRect(renderer, &rect);
+void PlayerView::drawRays(SDL_Renderer* renderer, const Player& player, const std::vector<RayHit>& rayResults,
+              SDL_FPoint origin, float pixelsPerCell) {
+    if (rayResults.empty()) {
+        return;
     }
 
-    void drawRays(SDL_Renderer* renderer, const Player& player, std::vector<RayHit> rayResults) {
-        for (const auto& ray : rayResults) {
-            //std::cout << "Distance: " << ray.distance << std::endl;
-            //std::cout << "Hit X: " << ray.hitX << std::endl;
-            //std::cout << "Hit Y: " << ray.hitY << std::endl;
-            //std::cout << "Wall Type: " << ray.wallType << std::endl;
-            //std::cout << "Hit Vertical Wall: " << (ray.hitVerticalWall ? "Yes" : "No") << std::endl;
-            //std::cout << "---" << std::endl;
+    float startX = origin.x + player.getX() * pixelsPerCell;
+    float startY = origin.y + player.getY() * pixelsPerCell;
 
-            float startX = player.getX() * 9; //Multiplied by 9 to normalise to pixel form instead of 2d vector
-            float startY = player.getY() * 9;
+    // One polyline that fans out from the player to every hit and back,
+    // so all rays go to the renderer in a single call
+    rayPoints.resize(rayResults.size() * 2);
+    for (size_t i = 0; i < rayResults.size(); i++) {
+        rayPoints[i * 2] = { startX, startY };
+        rayPoints[i * 2 + 1] = { origin.x + rayResults[i].hitX * pixelsPerCell,
+                                 origin.y + rayResults[i].hitY * pixelsPerCell };
+    }
 
-            float endX = ray.hitX * 9;
-            float endY = ray.hitY * 9;
+    SDL_SetRenderDrawColor(renderer, 255, 0, 0, 255);
+    SDL_RenderLines(renderer, rayPoints.data(), static_cast<int>(rayPoints.size()));
+}
 
-            SDL_SetRenderDrawColor(renderer, 255, 0, 0, 255);
-            SDL_RenderLine(renderer, startX, startY, endX , endY);
+bool Grid::rebuildMazeTexture(SDL_Renderer* renderer) {
+    textureWidth = cells.getWidth() * cellSize - borderSize;
+    textureHeight = cells.getHeight() * cellSize - borderSize;
 
-        }
+    releaseResources();
+    mazeTexture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_ARGB8888,
+                                    SDL_TEXTUREACCESS_STATIC, textureWidth, textureHeight);
+    if (!mazeTexture) {
+        std::cerr << "SDL_CreateTexture failed: " << SDL_GetError() << std::endl;
+        return false;
     }
-public:
-    void render(SDL_Renderer* renderer, Player player, std::vector<RayHit> rayResults) {
-        drawPlayer(renderer, player);
-        drawRays(renderer, player, rayResults);
-    }
-}; 
+    SDL_SetTextureBlendMode(mazeTexture, SDL_BLENDMODE_BLEND);
 
-class Grid {
-private:
-    int squareSize;
-    int borderSize;
-    int cellSize;
-    int width;
-    int height;
-    std::vector<std::vector<int>> worldMap;
+    mazePixels.assign(static_cast<size_t>(textureWidth) * textureHeight, 0);
 
-public:
-    Grid(int squareSize = 8, int borderSize = 1, int width = 566, int height = 566)
-        : squareSize(squareSize), borderSize(borderSize), width(width), height(height) {
-        cellSize = squareSize + borderSize;
+    for (int mapY = 0; mapY < cells.getHeight(); mapY++) {
+        for (int mapX = 0; mapX < cells.getWidth(); mapX++) {
+            paintCell(mapX, mapY, cells.at(mapX, mapY) > 0);
+        }
     }
 
-    void setWorldMap(const std::vector<std::vector<int>>& map) {
-        worldMap = map;
+    SDL_UpdateTexture(mazeTexture, nullptr, mazePixels.data(), textureWidth * static_cast<int>(sizeof(uint32_t)));
+    mazeRenderer = renderer;
+    mazeTextureDirty = false;
+    return true;
+}
+
+void Grid::applyPendingEdits(SDL_Renderer* renderer) {
+    std::lock_guard<std::mutex> lock(pendingMutex);
+    if (hasPendingMap) {
+        std::swap(cells, pendingMap);
+        hasPendingMap = false;
+        mazeTextureDirty = true;
     }
 
-    void render(SDL_Renderer* renderer) {
-        if (worldMap.empty()) {
-            // If no map is set, just draw black
-            SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
-            SDL_RenderClear(renderer);
-            return;
+    bool paint = textureIsCurrent(renderer);
+    const uint8_t* queued = pendingCells.data();
+    int pitch = textureWidth * static_cast<int>(sizeof(uint32_t));
+    for (const CellRect& rect : pendingRects) {
+        if (rect.x0 < 0 || rect.y0 < 0 || rect.x1 > cells.getWidth() || rect.y1 > cells.getHeight()) {
+            // Not the map the cells were copied from
+            queued += static_cast<size_t>(rect.area());
+            continue;
         }
-
-        int mapHeight = worldMap.size();
-        int mapWidth = worldMap[0].size();
-
-        // Draw grid based on worldMap
-        for (int mapY = 0; mapY < mapHeight; mapY++) {
-            for (int mapX = 0; mapX < mapWidth; mapX++) {
-                int cellValue = worldMap[mapY][mapX];
-                
-                // Set color based on cell value
-                if (cellValue > 0) {
-                    SDL_SetRenderDrawColor(renderer, 255, 255, 255, 255); // White for walls
-                } else {
-                    SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255); // Black for empty
+        for (int mapY = rect.y0; mapY < rect.y1; mapY++) {
+            uint8_t* row = cells.row(mapY);
+            for (int mapX = rect.x0; mapX < rect.x1; mapX++) {
+                row[mapX] = *queued++;
+                if (paint) {
+                    paintCell(mapX, mapY, row[mapX] > 0);
                 }
-                
-                SDL_FRect rect = {
-                    static_cast<float>(mapX * cellSize),
-                    static_cast<float>(mapY * cellSize),
-                    static_cast<float>(squareSize),
-                    static_cast<float>(squareSize)
-                };
-                SDL_RenderFillRect(renderer, &rect);
             }
         }
-    }
-};
-
-class MapWindow {
-private:
-    SDL_Window* window;
-    SDL_Renderer* renderer;
-    bool running;
-    Grid grid;
-    PlayerView playerView;
-    int windowWidth;
-    int windowHeight;
-
-    void cleanup() {
-        if (renderer) {
-            SDL_DestroyRenderer(renderer);
-            renderer = nullptr;
-        }
-        if (window) {
-            SDL_DestroyWindow(window);
-            window = nullptr;
+        if (!paint) {
+            continue;
         }
-        SDL_Quit();
-    }
 
-    void handleEvents() {
-        SDL_Event event;
-        while (SDL_PollEvent(&event)) {
-            if (event.type == SDL_EVENT_QUIT) {
-                running = false;
-            }
-            else if (event.type == SDL_EVENT_KEY_DOWN) {
-                if (event.key.key == SDLK_ESCAPE) {
-                    running = false;
-                }
+        // The last cell of the maze has no gap after it
+        int left = rect.x0 * cellSize;
+        int top = rect.y0 * cellSize;
+        SDL_Rect texels = { left, top, std::min(rect.x1 * cellSize, textureWidth) - left,
+                            std::min(rect.y1 * cellSize, textureHeight) - top };
+        SDL_UpdateTexture(mazeTexture, &texels, &mazePixels[static_cast<size_t>(top) * textureWidth + left], pitch);
+    }
+    pendingRects.clear();
+    pendingCells.clear();
+    hasPendingEdits.store(false, std::memory_order_relaxed);
+}
+
+void Grid::drawCells(SDL_Renderer* renderer, const SDL_FRect& area) {
+    float scale = area.w / (cells.getWidth() * cellSize - borderSize);
+    int mapHeight = cells.getHeight();
+    int mapWidth = cells.getWidth();
+
+    // Draw grid based on the copied cells
+    for (int mapY = 0; mapY < mapHeight; mapY++) {
+        for (int mapX = 0; mapX < mapWidth; mapX++) {
+            int cellValue = cells.at(mapX, mapY);
+            
+            // Set color based on cell value
+            if (cellValue > 0) {
+                SDL_SetRenderDrawColor(renderer, 255, 255, 255, 255); // White for walls
+            } else {
+                SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255); // Black for empty
             }
+            
+            SDL_FRect rect = {
+                area.x + mapX * cellSize * scale,
+                area.y + mapY * cellSize * scale,
+                squareSize * scale,
+                squareSize * scale
+            };
+            SDL_RenderFillRect(renderer, &rect);
+        }
+    }
+}
+
+void Grid::copyMap(const MapGrid& mapGrid) {
+    std::lock_guard<std::mutex> lock(pendingMutex);
+    pendingMap = mapGrid;
+    hasPendingMap = true;
+    pendingRects.clear();
+    pendingCells.clear();
+    mapWidth.store(mapGrid.getWidth(), std::memory_order_relaxed);
+    mapHeight.store(mapGrid.getHeight(), std::memory_order_relaxed);
+    hasPendingEdits.store(true, std::memory_order_release);
+}
+
+void Grid::queueEdit(const MapGrid& mapGrid, const CellRect& rect) {
+    std::lock_guard<std::mutex> lock(pendingMutex);
+    pendingRects.push_back(rect);
+    for (int y = rect.y0; y < rect.y1; y++) {
+        for (int x = rect.x0; x < rect.x1; x++) {
+            pendingCells.push_back(mapGrid.at(x, y));
         }
     }
+    hasPendingEdits.store(true, std::memory_order_release);
+}
 
-public:
-    MapWindow(int width = 566, int height = 566)
-        : window(nullptr), renderer(nullptr),
-          running(false), windowWidth(width), windowHeight(height) {}
+void Grid::releaseResources() {
+    if (mazeTexture) {
+        SDL_DestroyTexture(mazeTexture);
+        mazeTexture = nullptr;
+    }
+    mazeRenderer = nullptr;
+}
 
-    ~MapWindow() {
-        cleanup();
+void Grid::render(SDL_Renderer* renderer, const SDL_FRect& area) {
+    if (hasPendingEdits.load(std::memory_order_acquire)) {
+        applyPendingEdits(renderer);
     }
 
-    bool isRunning() {
-        return running;
+    if (cells.empty()) {
+        // If no map is set, just draw black
+        SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
+        SDL_RenderFillRect(renderer, &area);
+        return;
     }
 
-    bool init() {
-        // Initialize SDL
-        if (!SDL_Init(SDL_INIT_VIDEO)) {
-            std::cerr << "SDL_Init failed: " << SDL_GetError() << std::endl;
-            return false;
+    if (!textureIsCurrent(renderer)) {
+        if (!rebuildMazeTexture(renderer)) {
+            drawCells(renderer, area);
+            return;
         }
+    }
+    SDL_RenderTexture(renderer, mazeTexture, nullptr, &area);
+}
+
+void Minimap::render(SDL_Renderer* renderer, const Player& player, const std::vector<RayHit>& rayResults,
+            const SDL_FRect& area) {
+    {
+        ScopedTimer timer(profiler, ProfileSection::GRID_RENDER);
+        grid.render(renderer, area);
+    }
 
-        // Create window
-        window = SDL_CreateWindow(
-            "Grid Window",
-            windowWidth, windowHeight,
-            0
-        );
-        if (!window) {
-            std::cerr << "SDL_CreateWindow failed: " << SDL_GetError() << std::endl;
-            SDL_Quit();
-            return false;
-        }
+    ScopedTimer timer(profiler, ProfileSection::PLAYER_RENDER);
+    float pixelsPerCell = getPixelWidth() > 0 ? area.w * grid.getCellSize() / getPixelWidth() : 0.0f;
+    playerView.render(renderer, player, rayResults, { area.x, area.y }, pixelsPerCell);
+}
+
+bool MapWindow::init() {
+    window = SDL_CreateWindow(
+        "Grid Window",
+        windowWidth, windowHeight,
+        0
+    );
+    if (!window) {
+        std::cerr << "SDL_CreateWindow failed: " << SDL_GetError() << std::endl;
+        return false;
+    }
 
-        // Create renderer
-        renderer = SDL_CreateRenderer(window, nullptr);
-        if (!renderer) {
-            std::cerr << "SDL_CreateRenderer failed: " << SDL_GetError() << std::endl;
-            SDL_DestroyWindow(window);
-            SDL_Quit();
-            return false;
-        }
-        return true;
+    renderer = SDL_CreateRenderer(window, nullptr);
+    if (!renderer) {
+        std::cerr << "SDL_CreateRenderer failed: " << SDL_GetError() << std::endl;
+        SDL_DestroyWindow(window);
+        window = nullptr;
+        return false;
     }
+    return true;
+}
 
-    void initRun(WorldMap map) {
-        running = true;
+void MapWindow::close() {
+    if (minimap) {
+        minimap->releaseResources();
+    }
+    if (renderer) {
+        SDL_DestroyRenderer(renderer);
+        renderer = nullptr;
+    }
+    if (window) {
+        SDL_DestroyWindow(window);
+        window = nullptr;
+    }
+}
 
-        grid.setWorldMap(map.getMap());
+void MapWindow::update(const Player& player, const std::vector<RayHit>& rayResults) {
+    if (!isOpen()) {
+        return;
     }
 
-    void update(Player player, std::vector<RayHit> rayResults) {
-        // Handle events
-        handleEvents();
-        
-        // Clear the screen
-        SDL_SetRenderDrawColor(renderer, 50, 50, 50, 255);
-        SDL_RenderClear(renderer);
-        
-        // Render content
-        grid.render(renderer);
-        playerView.render(renderer, player, rayResults);
-        
-        // Present to screen
-        SDL_RenderPresent(renderer);
+    // Clear the screen
+    SDL_SetRenderDrawColor(renderer, 50, 50, 50, 255);
+    SDL_RenderClear(renderer);
 
-        SDL_Delay(16);
+    // Drawn at its own size, one map cell per Grid cellSize pixels
+    if (minimap) {
+        SDL_FRect area = { 0.0f, 0.0f, static_cast<float>(minimap->getPixelWidth()),
+                           static_cast<float>(minimap->getPixelHeight()) };
+        minimap->render(renderer, player, rayResults, area);
     }
-};
+
+    // Present to screen
+    ScopedTimer timer(profiler, ProfileSection::PRESENT);
+    SDL_RenderPresent(renderer);
+}
@@ -0,0 +1,282 @@
+#include "mazeFile.h"
+#include "mapGrid.h"
+
+#include <climits>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <fstream>
+
+#if defined(_WIN32)
+#define RAYCASTER_MAZE_FILE_MMAP 0
+#else
+#define RAYCASTER_MAZE_FILE_MMAP 1
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+MazeFileHeader makeHeader(MazeFileGenerator generator, MazeFileEncoding encoding, uint64_t seed,
+                          int width, int height, int stride) {
+    MazeFileHeader header;
+    std::memset(&header, 0, sizeof(header));
+    header.magic = MazeFileHeader::MAGIC;
+    header.byteOrderMark = MazeFileHeader::BYTE_ORDER_MARK;
+    header.version = MazeFileHeader::VERSION;
+    header.headerSize = sizeof(MazeFileHeader);
+    header.generator = static_cast<uint8_t>(generator);
+    header.encoding = static_cast<uint8_t>(encoding);
+    header.width = static_cast<uint32_t>(width);
+    header.height = static_cast<uint32_t>(height);
+    header.stride = static_cast<uint32_t>(stride);
+    header.seed = seed;
+    header.payloadOffset = (sizeof(MazeFileHeader) + MazeFileHeader::PAYLOAD_ALIGNMENT - 1)
+                           / MazeFileHeader::PAYLOAD_ALIGNMENT * MazeFileHeader::PAYLOAD_ALIGNMENT;
+    return header;
+}
+
+bool writeFile(const std::string& path, MazeFileHeader header, const uint8_t* payload, size_t size,
+               bool withChecksum) {
+    header.payloadSize = size;
+    header.checksum = withChecksum ? mazeFileChecksum(payload, size) : 0;
+
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out) {
+        std::cerr << "Could not open " << path << " for writing" << std::endl;
+        return false;
+    }
+
+    char padding[MazeFileHeader::PAYLOAD_ALIGNMENT] = {};
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.write(padding, static_cast<std::streamsize>(header.payloadOffset - sizeof(header)));
+    out.write(reinterpret_cast<const char*>(payload), static_cast<std::streamsize>(size));
+    if (!out) {
+        std::cerr << "Writing " << path << " failed" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+size_t packedWordCount(uint64_t width, uint64_t height) {
+    return static_cast<size_t>((width * height + 63) / 64);
+}
+
+// MapGrid and everything reading it index cells with int, so the whole
+// buffer, border and padding included, has to stay within INT_MAX bytes
+bool fitsGridIndex(uint64_t stride, uint64_t height) {
+    return stride <= INT_MAX
+        && stride * (height + 2 * MapGrid::BORDER) + MapGrid::TAIL_PADDING <= static_cast<uint64_t>(INT_MAX);
+}
+
+bool validateHeader(const std::string& path, const MazeFileHeader& header, uint64_t fileSize) {
+    const char* problem = nullptr;
+    if (header.magic != MazeFileHeader::MAGIC) {
+        problem = "not a maze file";
+    } else if (header.byteOrderMark != MazeFileHeader::BYTE_ORDER_MARK) {
+        problem = "written with a different byte order";
+    } else if (header.version != MazeFileHeader::VERSION || header.headerSize != sizeof(MazeFileHeader)) {
+        problem = "unsupported version";
+    } else if (header.width == 0 || header.height == 0 || header.width > 0x7FFFFFF0u || header.height > 0x7FFFFFF0u) {
+        problem = "bad dimensions";
+    } else if (header.payloadOffset < sizeof(MazeFileHeader) || header.payloadOffset > fileSize
+               || header.payloadSize > fileSize - header.payloadOffset) {
+        problem = "truncated";
+    } else if (header.encoding == static_cast<uint8_t>(MazeFileEncoding::GRID_BYTES)) {
+        if (!fitsGridIndex(header.stride, header.height)) {
+            problem = "too large to load";
+        } else if (header.stride < header.width + 2 * MapGrid::BORDER
+            || header.payloadSize < MapGrid::byteSizeFor(static_cast<int>(header.stride), static_cast<int>(header.height))) {
+            problem = "grid payload does not match its dimensions";
+        } else if (header.payloadOffset % MazeFileHeader::PAYLOAD_ALIGNMENT != 0) {
+            problem = "misaligned payload";
+        }
+    } else if (header.encoding == static_cast<uint8_t>(MazeFileEncoding::BITS)) {
+        // The stride MapGrid::strideFor will pick, worked out without overflowing int
+        uint64_t stride = (static_cast<uint64_t>(header.width) + 2 * MapGrid::BORDER + MapGrid::ROW_ALIGNMENT - 1)
+                          / MapGrid::ROW_ALIGNMENT * MapGrid::ROW_ALIGNMENT;
+        if (!fitsGridIndex(stride, header.height)) {
+            problem = "too large to load";
+        } else if (header.payloadSize < packedWordCount(header.width, header.height) * sizeof(uint64_t)) {
+            problem = "bit payload does not match its dimensions";
+        }
+    } else {
+        problem = "unknown encoding";
+    }
+
+    if (problem) {
+        std::cerr << path << ": " << problem << std::endl;
+        return false;
+    }
+    return true;
+}
+
+// The DDA only stays inside the buffer if the ring around the map is solid
+bool borderIsSolid(const uint8_t* cells, int width, int height, int stride) {
+    const uint8_t* top = cells;
+    const uint8_t* bottom = cells + static_cast<size_t>(height + 2 * MapGrid::BORDER - 1) * stride;
+    for (int x = 0; x < width + 2 * MapGrid::BORDER; x++) {
+        if (top[x] == 0 || bottom[x] == 0) {
+            return false;
+        }
+    }
+    for (int y = 0; y < height + 2 * MapGrid::BORDER; y++) {
+        const uint8_t* row = cells + static_cast<size_t>(y) * stride;
+        if (row[0] == 0 || row[width + MapGrid::BORDER] == 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void unpackBits(const uint64_t* words, MapGrid& grid) {
+    int width = grid.getWidth();
+    for (int y = 0; y < grid.getHeight(); y++) {
+        uint8_t* out = grid.row(y);
+        uint64_t bit = static_cast<uint64_t>(y) * width;
+        for (int x = 0; x < width; x++, bit++) {
+            out[x] = static_cast<uint8_t>((words[bit >> 6] >> (bit & 63)) & 1);
+        }
+    }
+}
+
+} // namespace
+
+uint64_t mazeFileChecksum(const uint8_t* data, size_t size) {
+    uint64_t hash = 0xCBF29CE484222325ull;
+    for (size_t i = 0; i < size; i++) {
+        hash = (hash ^ data[i]) * 0x100000001B3ull;
+    }
+    return hash;
+}
+
+bool writeMazeFile(const std::string& path, const std::vector<std::vector<int>>& maze,
+                   MazeFileGenerator generator, uint64_t seed, MazeFileEncoding encoding, bool withChecksum) {
+    int height = static_cast<int>(maze.size());
+    int width = height > 0 ? static_cast<int>(maze[0].size()) : 0;
+    if (width == 0 || height == 0) {
+        std::cerr << "Refusing to write an empty maze to " << path << std::endl;
+        return false;
+    }
+
+    if (encoding == MazeFileEncoding::BITS) {
+        std::vector<uint64_t> words(packedWordCount(width, height), 0);
+        for (int y = 0; y < height; y++) {
+            for (int x = 0; x < width && x < static_cast<int>(maze[y].size()); x++) {
+                if (maze[y][x] != 0) {
+                    uint64_t bit = static_cast<uint64_t>(y) * width + x;
+                    words[bit >> 6] |= uint64_t(1) << (bit & 63);
+                }
+            }
+        }
+        MazeFileHeader header = makeHeader(generator, encoding, seed, width, height, 0);
+        return writeFile(path, header, reinterpret_cast<const uint8_t*>(words.data()),
+                         words.size() * sizeof(uint64_t), withChecksum);
+    }
+
+    // Built as a real grid so the bytes on disk are exactly what loading maps back in
+    MapGrid grid(maze, height, width);
+    MazeFileHeader header = makeHeader(generator, encoding, seed, width, height, grid.getStride());
+    return writeFile(path, header, grid.data(), grid.getByteSize(), withChecksum);
+}
+
+bool writePackedMazeFile(const std::string& path, const std::vector<uint64_t>& wallBits, int width, int height,
+                         MazeFileGenerator generator, uint64_t seed, bool withChecksum) {
+    size_t words = packedWordCount(width, height);
+    if (width <= 0 || height <= 0 || wallBits.size() < words) {
+        std::cerr << "Packed maze does not match its dimensions, not writing " << path << std::endl;
+        return false;
+    }
+    MazeFileHeader header = makeHeader(generator, MazeFileEncoding::BITS, seed, width, height, 0);
+    return writeFile(path, header, reinterpret_cast<const uint8_t*>(wallBits.data()),
+                     words * sizeof(uint64_t), withChecksum);
+}
+
+bool loadMazeFile(const std::string& path, MapGrid& grid, MazeFileHeader* headerOut, bool verifyChecksum) {
+    std::shared_ptr<void> storage;
+    uint8_t* fileData = nullptr;
+    uint64_t fileSize = 0;
+
+#if RAYCASTER_MAZE_FILE_MMAP
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        std::cerr << "Could not open " << path << std::endl;
+        return false;
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size < static_cast<off_t>(sizeof(MazeFileHeader))) {
+        std::cerr << path << ": too small to be a maze file" << std::endl;
+        close(fd);
+        return false;
+    }
+    fileSize = static_cast<uint64_t>(info.st_size);
+
+    // Private writable mapping: the grid can be edited without touching the file
+    void* mapped = mmap(nullptr, fileSize, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (mapped == MAP_FAILED) {
+        std::cerr << "mmap of " << path << " failed" << std::endl;
+        return false;
+    }
+    size_t mappedSize = static_cast<size_t>(fileSize);
+    storage = std::shared_ptr<void>(mapped, [mappedSize](void* address) { munmap(address, mappedSize); });
+    fileData = static_cast<uint8_t*>(mapped);
+#else
+    // No mmap here, read the file into one buffer the grid keeps instead
+    std::ifstream in(path, std::ios::binary | std::ios::ate);
+    if (!in) {
+        std::cerr << "Could not open " << path << std::endl;
+        return false;
+    }
+    fileSize = static_cast<uint64_t>(in.tellg());
+    if (fileSize < sizeof(MazeFileHeader)) {
+        std::cerr << path << ": too small to be a maze file" << std::endl;
+        return false;
+    }
+    std::shared_ptr<std::vector<uint8_t>> buffer = std::make_shared<std::vector<uint8_t>>(fileSize);
+    in.seekg(0);
+    in.read(reinterpret_cast<char*>(buffer->data()), static_cast<std::streamsize>(fileSize));
+    if (!in) {
+        std::cerr << "Reading " << path << " failed" << std::endl;
+        return false;
+    }
+    fileData = buffer->data();
+    storage = buffer;
+#endif
+
+    MazeFileHeader header;
+    std::memcpy(&header, fileData, sizeof(header));
+    if (!validateHeader(path, header, fileSize)) {
+        return false;
+    }
+
+    uint8_t* payload = fileData + header.payloadOffset;
+    if (verifyChecksum && header.checksum != 0
+        && mazeFileChecksum(payload, static_cast<size_t>(header.payloadSize)) != header.checksum) {
+        std::cerr << path << ": checksum mismatch" << std::endl;
+        return false;
+    }
+
+    int width = static_cast<int>(header.width);
+    int height = static_cast<int>(header.height);
+
+    if (header.encoding == static_cast<uint8_t>(MazeFileEncoding::BITS)) {
+        MapGrid unpacked(width, height);
+        unpackBits(reinterpret_cast<const uint64_t*>(payload), unpacked);
+        grid = std::move(unpacked);
+    } else {
+        int stride = static_cast<int>(header.stride);
+        if (!borderIsSolid(payload, width, height, stride)) {
+            std::cerr << path << ": border is not solid" << std::endl;
+            return false;
+        }
+        grid = MapGrid(std::move(storage), payload, static_cast<size_t>(header.payloadSize), width, height, stride);
+    }
+
+    if (headerOut) {
+        *headerOut = header;
+    }
+    return true;
+}
@@ -0,0 +1,27 @@
+#include "movementSystem.h"
+
+void MovementSystem::update(MovementBatch& batch, float deltaTime) const {
+    int count = batch.size();
+    auto moveEntities = [&](int task) {
+        int first = task * ENTITIES_PER_TASK;
+        int end = std::min(first + ENTITIES_PER_TASK, count);
+        for (int i = first; i < end; i++) {
+            if (batch.turnRate[i] != 0.0f) {
+                batch.setAngle(i, batch.angle[i] + batch.turnRate[i] * deltaTime);
+            }
+            float distance = batch.speed[i] * deltaTime;
+            batch.blocked[i] = distance != 0.0f &&
+                worldMap.moveBox(batch.x[i], batch.y[i], batch.halfSize[i],
+                                 batch.dirX[i] * distance, batch.dirY[i] * distance);
+        }
+    };
+
+    int taskCount = (count + ENTITIES_PER_TASK - 1) / ENTITIES_PER_TASK;
+    if (!threadPool || taskCount <= 1) {
+        for (int task = 0; task < taskCount; task++) {
+            moveEntities(task);
+        }
+        return;
+    }
+    threadPool->parallelFor(taskCount, moveEntities);
+}
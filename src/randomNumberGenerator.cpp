@@ -1,13 +1,12 @@
-#pragma once
-
 #include <ctime>
 #include <random>
 #include <stdexcept>
 #include "randomNumberGenerator.h"
 
 /**
- * @brief Default constructor - automatically seeds with current time Creates a RandomNumberGenerator instance seeded with the current system time. This ensures different random sequences on each program execution. */ RandomNumberGenerator::RandomNumberGenerator() {
+ * @brief Default constructor - automatically seeds with current time Creates a RandomNumberGenerator instance seeded with the current system time. This ensures different random sequences on each program execution. */ RandomNumberGenerator::RandomNumberGenerator() : engine(RandomEngine::MT19937), streamValue(0) {
     int seed = std::time(nullptr);  // Get current time as seed
+    seedValue = static_cast<unsigned int>(seed);
     generator.seed(seed);
 }
 
@@ -20,15 +19,259 @@
  * 
  * @param seed The seed value for the random number generator
  */
-RandomNumberGenerator::RandomNumberGenerator(unsigned int seed) {
+RandomNumberGenerator::RandomNumberGenerator(unsigned int seed)
+    : engine(RandomEngine::MT19937), seedValue(seed), streamValue(0) {
     generator.seed(seed);
 }
 
+/**
+ * @brief Constructor with an explicit engine and stream
+ *
+ * @param seed Seed value, the full 64 bits are used by the fast engines
+ * @param engine Bit generator to use
+ * @param stream Independent sequence of this seed
+ */
+RandomNumberGenerator::RandomNumberGenerator(uint64_t seed, RandomEngine engine, uint64_t stream)
+    : engine(engine), seedValue(seed), streamValue(stream) {
+    seedEngine();
+}
+
+namespace {
+
+uint64_t splitMix64(uint64_t& state) {
+    uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+uint64_t rotateLeft(uint64_t value, int shift) {
+    return (value << shift) | (value >> (64 - shift));
+}
+
+const uint64_t PCG_MULTIPLIER = 6364136223846793005ull;
+
+} // namespace
+
+/**
+ * @brief Put the selected engine at the start of (seedValue, streamValue)
+ */
+void RandomNumberGenerator::seedEngine() {
+    switch (engine) {
+        case RandomEngine::MT19937: {
+            uint64_t mix = seedValue ^ (streamValue * 0xD1B54A32D192ED03ull);
+            generator.seed(static_cast<unsigned int>(streamValue == 0 ? seedValue : splitMix64(mix)));
+            break;
+        }
+        case RandomEngine::XOSHIRO256: {
+            // SplitMix64 expands the seed, as the xoshiro authors recommend
+            uint64_t mix = seedValue ^ (streamValue * 0xD1B54A32D192ED03ull);
+            for (uint64_t& word : xoshiroState) {
+                word = splitMix64(mix);
+            }
+            break;
+        }
+        case RandomEngine::PCG32:
+            // pcg32_srandom: the stream selects the (odd) increment
+            pcgState = 0;
+            pcgIncrement = (streamValue << 1) | 1;
+            next32();
+            pcgState += seedValue;
+            next32();
+            break;
+        case RandomEngine::PHILOX:
+            philoxPosition = 0;
+            philoxBufferedBlock = ~uint64_t(0);
+            break;
+    }
+}
+
+/**
+ * @brief Philox4x32-10 of counter (block, stream) under the seed as key
+ */
+void RandomNumberGenerator::philoxBlock(uint64_t block) {
+    uint32_t counter[4] = {
+        static_cast<uint32_t>(block), static_cast<uint32_t>(block >> 32),
+        static_cast<uint32_t>(streamValue), static_cast<uint32_t>(streamValue >> 32)
+    };
+    uint32_t key[2] = { static_cast<uint32_t>(seedValue), static_cast<uint32_t>(seedValue >> 32) };
+
+    for (int round = 0; round < 10; round++) {
+        uint64_t product0 = static_cast<uint64_t>(0xD2511F53u) * counter[0];
+        uint64_t product1 = static_cast<uint64_t>(0xCD9E8D57u) * counter[2];
+        uint32_t next[4] = {
+            static_cast<uint32_t>(product1 >> 32) ^ counter[1] ^ key[0],
+            static_cast<uint32_t>(product1),
+            static_cast<uint32_t>(product0 >> 32) ^ counter[3] ^ key[1],
+            static_cast<uint32_t>(product0)
+        };
+        counter[0] = next[0];
+        counter[1] = next[1];
+        counter[2] = next[2];
+        counter[3] = next[3];
+        key[0] += 0x9E3779B9u;
+        key[1] += 0xBB67AE85u;
+    }
+
+    for (int i = 0; i < 4; i++) {
+        philoxOutput[i] = counter[i];
+    }
+    philoxBufferedBlock = block;
+}
+
+uint32_t RandomNumberGenerator::next32() {
+    switch (engine) {
+        case RandomEngine::MT19937:
+            return static_cast<uint32_t>(generator());
+        case RandomEngine::XOSHIRO256:
+            return static_cast<uint32_t>(next64() >> 32); // High bits are the strongest
+        case RandomEngine::PCG32: {
+            uint64_t old = pcgState;
+            pcgState = old * PCG_MULTIPLIER + pcgIncrement;
+            uint32_t xorShifted = static_cast<uint32_t>(((old >> 18) ^ old) >> 27);
+            uint32_t rotation = static_cast<uint32_t>(old >> 59);
+            return (xorShifted >> rotation) | (xorShifted << ((32 - rotation) & 31));
+        }
+        case RandomEngine::PHILOX:
+        default: {
+            uint64_t block = philoxPosition >> 2;
+            if (block != philoxBufferedBlock) {
+                philoxBlock(block);
+            }
+            return philoxOutput[philoxPosition++ & 3];
+        }
+    }
+}
+
+uint64_t RandomNumberGenerator::next64() {
+    if (engine != RandomEngine::XOSHIRO256) {
+        uint64_t high = next32();
+        return (high << 32) | next32();
+    }
+
+    uint64_t* state = xoshiroState;
+    uint64_t result = rotateLeft(state[1] * 5, 7) * 9;
+    uint64_t shifted = state[1] << 17;
+    state[2] ^= state[0];
+    state[3] ^= state[1];
+    state[1] ^= state[2];
+    state[0] ^= state[3];
+    state[2] ^= shifted;
+    state[3] = rotateLeft(state[3], 45);
+    return result;
+}
+
+uint64_t RandomNumberGenerator::randomBits(int bits) {
+    if (bits <= 0) {
+        return 0;
+    }
+    if (bits <= 32) {
+        return next32() >> (32 - bits);
+    }
+    return next64() >> (64 - std::min(bits, 64));
+}
+
+void RandomNumberGenerator::fillRandom(uint32_t* out, size_t count) {
+    switch (engine) {
+        case RandomEngine::XOSHIRO256:
+            for (size_t i = 0; i < count; i++) {
+                out[i] = static_cast<uint32_t>(next64() >> 32);
+            }
+            break;
+        case RandomEngine::PHILOX:
+            // Whole blocks straight from the counter, the buffer only covers a partial block
+            while (count > 0 && (philoxPosition & 3) != 0) {
+                *out++ = next32();
+                count--;
+            }
+            while (count >= 4) {
+                philoxBlock(philoxPosition >> 2);
+                for (int i = 0; i < 4; i++) {
+                    out[i] = philoxOutput[i];
+                }
+                philoxPosition += 4;
+                out += 4;
+                count -= 4;
+            }
+            while (count > 0) {
+                *out++ = next32();
+                count--;
+            }
+            break;
+        default:
+            for (size_t i = 0; i < count; i++) {
+                out[i] = next32();
+            }
+            break;
+    }
+}
+
+void RandomNumberGenerator::discard(uint64_t count) {
+    switch (engine) {
+        case RandomEngine::MT19937:
+            generator.discard(count);
+            break;
+        case RandomEngine::PCG32: {
+            // Jump the LCG by squaring, Brown's "random number generation with arbitrary strides"
+            uint64_t multiplier = PCG_MULTIPLIER;
+            uint64_t increment = pcgIncrement;
+            uint64_t totalMultiplier = 1;
+            uint64_t totalIncrement = 0;
+            while (count > 0) {
+                if (count & 1) {
+                    totalMultiplier *= multiplier;
+                    totalIncrement = totalIncrement * multiplier + increment;
+                }
+                increment = (multiplier + 1) * increment;
+                multiplier *= multiplier;
+                count >>= 1;
+            }
+            pcgState = totalMultiplier * pcgState + totalIncrement;
+            break;
+        }
+        case RandomEngine::PHILOX:
+            philoxPosition += count;
+            break;
+        default:
+            for (uint64_t i = 0; i < count; i++) {
+                next64();
+            }
+            break;
+    }
+}
+
+void RandomNumberGenerator::setStream(uint64_t stream) {
+    streamValue = stream;
+    seedEngine();
+}
+
+RandomEngine RandomNumberGenerator::getEngine() const {
+    return engine;
+}
+
+uint32_t RandomNumberGenerator::bounded(uint32_t range) {
+    if (engine == RandomEngine::MT19937) {
+        std::uniform_int_distribution<int> dist(0, static_cast<int>(range - 1));
+        return static_cast<uint32_t>(dist(generator));
+    }
+
+    uint64_t product = static_cast<uint64_t>(next32()) * range;
+    uint32_t low = static_cast<uint32_t>(product);
+    if (low < range) {
+        uint32_t threshold = (0u - range) % range;
+        while (low < threshold) {
+            product = static_cast<uint64_t>(next32()) * range;
+            low = static_cast<uint32_t>(product);
+        }
+    }
+    return static_cast<uint32_t>(product >> 32);
+}
+
 /**
  * @brief Generate random integer within specified range (inclusive)
  * 
- * Uses std::uniform_int_distribution to ensure uniform distribution
- * across the specified range.
+ * Uses std::uniform_int_distribution with MT19937, so existing seeds keep
+ * their sequences, and Lemire's bias-free multiply-shift with the other engines.
  * 
  * @param min Minimum value (inclusive)
  * @param max Maximum value (inclusive)
@@ -41,6 +284,13 @@ int RandomNumberGenerator::randomInt(int min, int max) {
         throw std::invalid_argument("min cannot be greater than max");
     }
 
+    if (engine != RandomEngine::MT19937) {
+        // Range can be up to 2^32 - 1 wide, so work in 64 bits
+        uint64_t span = static_cast<uint64_t>(static_cast<int64_t>(max) - min) + 1;
+        uint32_t offset = span > 0xFFFFFFFFull ? next32() : bounded(static_cast<uint32_t>(span));
+        return static_cast<int>(static_cast<int64_t>(min) + offset);
+    }
+
     // Create uniform distribution for the specified range
     std::uniform_int_distribution<int> dist(min, max);
     return dist(generator);
@@ -77,12 +327,9 @@ int RandomNumberGenerator::randomOdd(int min, int max) {
     // Example: between 1 and 7, there are (7-1)/2 + 1 = 4 odd numbers: 1,3,5,7
     int numOdds = (max - min) / 2 + 1;
     
-    // Generate random index among odd numbers
-    std::uniform_int_distribution<int> dist(0, numOdds - 1);
-    
-    // Convert index to actual odd number
+    // Convert a random index to actual odd number
     // min + (index * 2) gives us the index-th odd number starting from min
-    return min + (dist(generator) * 2);
+    return min + (static_cast<int>(bounded(static_cast<uint32_t>(numOdds))) * 2);
 }
 
 /**
@@ -116,12 +363,9 @@ int RandomNumberGenerator::randomEven(int min, int max) {
     // Example: between 2 and 8, there are (8-2)/2 + 1 = 4 even numbers: 2,4,6,8
     int numEvens = (max - min) / 2 + 1;
     
-    // Generate random index among even numbers
-    std::uniform_int_distribution<int> dist(0, numEvens - 1);
-    
-    // Convert index to actual even number
+    // Convert a random index to actual even number
     // min + (index * 2) gives us the index-th even number starting from min
-    return min + (dist(generator) * 2);
+    return min + (static_cast<int>(bounded(static_cast<uint32_t>(numEvens))) * 2);
 }
 
 /**
@@ -133,6 +377,9 @@ int RandomNumberGenerator::randomEven(int min, int max) {
  * @return true or false with equal probability
  */
 bool RandomNumberGenerator::randomBoolean() {
+    if (engine != RandomEngine::MT19937) {
+        return (next32() >> 31) != 0;
+    }
     std::uniform_int_distribution<int> dist(0, 1);
     return dist(generator) == 1;
 }
@@ -147,5 +394,7 @@ bool RandomNumberGenerator::randomBoolean() {
  * @param seed The new seed value for the generator
  */
 void RandomNumberGenerator::setSeed(unsigned int seed) {
-    generator.seed(seed);
+    seedValue = seed;
+    streamValue = 0;
+    seedEngine();
 } 
@@ -0,0 +1,42 @@
+#include "rayPacket.h"
+
+typedef float PacketFloat4 __attribute__((vector_size(16)));
+typedef int32_t PacketInt4 __attribute__((vector_size(16)));
+
+/**
+ * @brief Lane operations for the 4 wide kernel
+ *
+ * There is no gather below AVX2, so each active lane loads its cell on
+ * its own. Everything else stays in SSE2/NEON registers.
+ */
+struct PacketLanes4 {
+    static PacketInt4 gather(const uint8_t* cells, PacketInt4 index, PacketInt4 active) {
+        PacketInt4 result = {
+            cells[index[0]], cells[index[1]], cells[index[2]], cells[index[3]]
+        };
+        return result & active;
+    }
+
+    static bool any(PacketInt4 mask) {
+        return (mask[0] | mask[1] | mask[2] | mask[3]) != 0;
+    }
+};
+
+/**
+ * @brief Pick the widest packet kernel the CPU can run
+ *
+ * The AVX2 kernel is only compiled on x86 targets; there we ask CPUID
+ * whether it can actually be used on this machine.
+ */
+int detectPacketLanes() {
+#if defined(RAYCASTER_AVX2_KERNEL)
+    if (__builtin_cpu_supports("avx2")) {
+        return 8;
+    }
+#endif
+    return 4;
+}
+
+void castRayPacket4(const RayPacketQuery& query, RayPacketHits& hits) {
+    traceRayPacket<PacketFloat4, PacketInt4, 4, PacketLanes4>(query, hits);
+}
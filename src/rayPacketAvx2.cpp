@@ -0,0 +1,34 @@
+// Built with -mavx2 (see CMakeLists.txt). Keep this file free of anything
+// but the kernel so no AVX2 code can end up shared with other translation units.
+#if defined(RAYCASTER_AVX2_KERNEL)
+
+#include <immintrin.h>
+#include "rayPacket.h"
+
+typedef float PacketFloat8 __attribute__((vector_size(32)));
+typedef int32_t PacketInt8 __attribute__((vector_size(32)));
+
+/**
+ * @brief Lane operations for the 8 wide kernel
+ *
+ * Wall lookups use a masked 32-bit gather at byte offsets and keep the low
+ * byte. MapGrid pads the end of its buffer so the widest read stays inside it.
+ */
+struct PacketLanes8 {
+    static PacketInt8 gather(const uint8_t* cells, PacketInt8 index, PacketInt8 active) {
+        __m256i words = _mm256_mask_i32gather_epi32(_mm256_setzero_si256(),
+                                                    reinterpret_cast<const int*>(cells),
+                                                    (__m256i)index, (__m256i)active, 1);
+        return (PacketInt8)words & 0xFF;
+    }
+
+    static bool any(PacketInt8 mask) {
+        return !_mm256_testz_si256((__m256i)mask, (__m256i)mask);
+    }
+};
+
+void castRayPacket8(const RayPacketQuery& query, RayPacketHits& hits) {
+    traceRayPacket<PacketFloat8, PacketInt8, 8, PacketLanes8>(query, hits);
+}
+
+#endif
@@ -1,186 +1,598 @@
-#pragma once
-
-#include "game.cpp"
-#include <math.h>
-
-class RayHit {
-public:
-    float distance;
-    float hitX;
-    float hitY;
-    int wallType;
-    bool hitVerticalWall;
-    float angle;
-};
-
-enum class WallType {
-    HORIZONTAL,
-    VERTICAL
-};
-
-class Raycaster {
-private:
-    std::vector<std::vector<int>> worldMap;
-    float maxRayDistance;
-
-    // Helper function to normalize angle difference to [-π, π]
-    float normalizeAngleDiff(float angle) {
-        while (angle > M_PI) angle -= 2 * M_PI;
-        while (angle < -M_PI) angle += 2 * M_PI;
-        return angle;
-    }
-
-    RayHit castSingleRay(float startX, float startY, float angle, float playerAngle) {
-        float rayDirectionX = cos(angle);
-        float rayDirectionY = sin(angle);
-
-        int currentMapX = floor(startX);
-        int currentMapY = floor(startY);
-
-        float deltaDistX = abs(1 / rayDirectionX);
-        float deltaDistY = abs(1 / rayDirectionY);
-
-        int stepX;
-        int stepY;
-        float sideDistX;
-        float sideDistY;
-
-        if (rayDirectionX < 0) {
-            stepX = -1;
-            sideDistX = (startX - currentMapX) * deltaDistX;
-        } else {
-            stepX = 1;
-            sideDistX = (currentMapX + 1 - startX) * deltaDistX;
+#include "raycaster.h"
+
+void Raycaster::updateColumnTable(int screenWidth, float FOV) {
+    if (screenWidth == columnTableWidth && FOV == columnTableFOV) {
+        return;
+    }
+
+    float planeLength = planeLengthFor(FOV);
+
+    columnPlaneOffsets.resize(screenWidth);
+    columnBearings.resize(screenWidth);
+    for (int x = 0; x < screenWidth; x++) {
+        // Ray position on camera plane (-1 to +1)
+        float cameraX = 2.0f * x / (float)screenWidth - 1.0f;
+        columnPlaneOffsets[x] = cameraX * planeLength;
+        columnBearings[x] = atan(columnPlaneOffsets[x]);
+    }
+
+    // Worst case is every other column left to cast. The cache buffers
+    // are sized here too so the first turn after a resize doesn't allocate.
+    castTasks.reserve(screenWidth);
+    cachedHits.reserve(screenWidth);
+    cachedBearings.reserve(screenWidth);
+    nextBearings.reserve(screenWidth);
+    rayCacheValid = false;
+
+    columnTableWidth = screenWidth;
+    columnTableFOV = FOV;
+}
+
+RayHit Raycaster::castSingleRay(float startX, float startY, float rayDirectionX, float rayDirectionY, uint64_t& steps) const {
+    int currentMapX = floor(startX);
+    int currentMapY = floor(startY);
+
+    float deltaDistX = abs(1 / rayDirectionX);
+    float deltaDistY = abs(1 / rayDirectionY);
+
+    int stepX;
+    int stepY;
+    float sideDistX;
+    float sideDistY;
+
+    if (rayDirectionX < 0) {
+        stepX = -1;
+        sideDistX = (startX - currentMapX) * deltaDistX;
+    } else {
+        stepX = 1;
+        sideDistX = (currentMapX + 1 - startX) * deltaDistX;
+    }
+
+    if (rayDirectionY < 0) {
+        stepY = -1;
+        sideDistY = (startY - currentMapY) * deltaDistY;
+    } else {
+        stepY = 1;
+        sideDistY = (currentMapY + 1 - startY) * deltaDistY;
+    }
+
+    RayHit rayHit = RayHit();
+    rayHit.rayDirX = rayDirectionX;
+    rayHit.rayDirY = rayDirectionY;
+
+    const MapGrid& grid = worldMap.getGrid();
+    const uint8_t* cells = grid.data();
+
+    // The border around the grid is solid, so once the start cell is inside
+    // the map the walk below can never leave the buffer
+    if (!grid.inBounds(currentMapX, currentMapY)) {
+        rayHit.distance = 0.0f;
+        rayHit.hitX = startX;
+        rayHit.hitY = startY;
+        rayHit.wallType = MapGrid::BORDER_WALL;
+        rayHit.hitVerticalWall = false;
+        return rayHit;
+    }
+
+    // Step through the flat grid by index instead of by (x, y)
+    int cellIndex = grid.index(currentMapX, currentMapY);
+    int cellStepX = stepX;
+    int cellStepY = stepY * grid.getStride();
+
+    bool hitWall = false;
+    WallType hitSide = WallType::VERTICAL;
+
+    // Distance along the ray to the side of the cell being entered
+    float distance = 0.0f;
+
+    while (true) {
+        bool crossesX = sideDistX < sideDistY;
+        distance = crossesX ? sideDistX : sideDistY;
+        if (distance > maxRayDistance) {
+            break;
         }
 
-        if (rayDirectionY < 0) {
-            stepY = -1;
-            sideDistY = (startY - currentMapY) * deltaDistY;
+        steps++;
+        if (crossesX) {
+            sideDistX = sideDistX + deltaDistX;
+            cellIndex = cellIndex + cellStepX;
+            hitSide = WallType::VERTICAL;
         } else {
-            stepY = 1;
-            sideDistY = (currentMapY + 1 - startY) * deltaDistY;
+            sideDistY = sideDistY + deltaDistY;
+            cellIndex = cellIndex + cellStepY;
+            hitSide = WallType::HORIZONTAL;
         }
 
-        bool hitWall = false;
-        WallType hitSide;
+        if (cells[cellIndex] != 0) {
+            hitWall = true;
+            break;
+        }
+    }
 
-        float distance = 0.0;
+    // Rays that run out of range report an empty cell at the maximum distance
+    float wallDistance = hitWall ? distance : maxRayDistance;
+
+    rayHit.distance = wallDistance;
+    rayHit.hitX = startX + rayDirectionX * wallDistance;
+    rayHit.hitY = startY + rayDirectionY * wallDistance;
+    rayHit.wallType = hitWall ? cells[cellIndex] : 0;
+    rayHit.hitVerticalWall = (hitSide == WallType::VERTICAL);
+    return rayHit;
+}
+
+RayHit Raycaster::castSkippingRay(float startX, float startY, float rayDirectionX, float rayDirectionY, uint64_t& steps) const {
+    const MapGrid& grid = worldMap.getGrid();
+    int cellX = floor(startX);
+    int cellY = floor(startY);
+
+    RayHit rayHit = RayHit();
+    rayHit.rayDirX = rayDirectionX;
+    rayHit.rayDirY = rayDirectionY;
+
+    if (!grid.inBounds(cellX, cellY)) {
+        rayHit.distance = 0.0f;
+        rayHit.hitX = startX;
+        rayHit.hitY = startY;
+        rayHit.wallType = MapGrid::BORDER_WALL;
+        rayHit.hitVerticalWall = false;
+        return rayHit;
+    }
+
+    float deltaDistX = abs(1 / rayDirectionX);
+    float deltaDistY = abs(1 / rayDirectionY);
+    int stepX = rayDirectionX < 0 ? -1 : 1;
+    int stepY = rayDirectionY < 0 ? -1 : 1;
+
+    // Distances along the ray to the next x and y cell sides, valid for any cell on the ray
+    auto sideDistanceX = [&](int x) { return (stepX < 0 ? startX - x : x + 1 - startX) * deltaDistX; };
+    auto sideDistanceY = [&](int y) { return (stepY < 0 ? startY - y : y + 1 - startY) * deltaDistY; };
+    float sideDistX = sideDistanceX(cellX);
+    float sideDistY = sideDistanceY(cellY);
+
+    const uint8_t* cells = grid.data();
+    const uint8_t* freeRadius = distanceField->data();
+    int stride = grid.getStride();
+    int cellIndex = grid.index(cellX, cellY);
+
+    bool hitWall = false;
+    WallType hitSide = WallType::VERTICAL;
+    float distance = 0.0f;
+
+    while (true) {
+        int radius = freeRadius[cellIndex] - 1;
+        if (radius >= 1) {
+            // Leave the empty (2 * radius + 1) square centred on this cell
+            float exitX = abs((stepX < 0 ? cellX - radius : cellX + radius + 1) - startX) * deltaDistX;
+            float exitY = abs((stepY < 0 ? cellY - radius : cellY + radius + 1) - startY) * deltaDistY;
+            bool exitsX = exitX < exitY;
+            distance = exitsX ? exitX : exitY;
+            if (distance > maxRayDistance) {
+                break;
+            }
 
-        while (!hitWall && distance < maxRayDistance) {
-            if (sideDistX < sideDistY) {
-                sideDistX = sideDistX + deltaDistX;
-                currentMapX = currentMapX + stepX;
+            steps++;
+            if (exitsX) {
+                int landY = static_cast<int>(floor(startY + rayDirectionY * distance));
+                cellY = std::min(std::max(landY, cellY - radius), cellY + radius);
+                cellX += stepX * (radius + 1);
                 hitSide = WallType::VERTICAL;
             } else {
-                sideDistY = sideDistY + deltaDistY;
-                currentMapY = currentMapY + stepY;
+                int landX = static_cast<int>(floor(startX + rayDirectionX * distance));
+                cellX = std::min(std::max(landX, cellX - radius), cellX + radius);
+                cellY += stepY * (radius + 1);
                 hitSide = WallType::HORIZONTAL;
             }
+            sideDistX = sideDistanceX(cellX);
+            sideDistY = sideDistanceY(cellY);
+            cellIndex = (cellY + MapGrid::BORDER) * stride + (cellX + MapGrid::BORDER);
+        } else {
+            bool crossesX = sideDistX < sideDistY;
+            distance = crossesX ? sideDistX : sideDistY;
+            if (distance > maxRayDistance) {
+                break;
+            }
 
-            if (currentMapY < 0 || currentMapY >= worldMap.size() || 
-                currentMapX < 0 || currentMapX >= worldMap[0].size()) {
-                hitWall = true;
-            } else if (worldMap[currentMapY][currentMapX] != 0) {
-                hitWall = true;
+            steps++;
+            if (crossesX) {
+                sideDistX += deltaDistX;
+                cellX += stepX;
+                cellIndex += stepX;
+                hitSide = WallType::VERTICAL;
+            } else {
+                sideDistY += deltaDistY;
+                cellY += stepY;
+                cellIndex += stepY * stride;
+                hitSide = WallType::HORIZONTAL;
             }
         }
 
-        // FIXED: Use the DDA's accumulated distance directly
-        // This is the actual ray travel distance from the DDA algorithm
-        float wallDistance;
-        if (hitSide == WallType::VERTICAL) {
-            wallDistance = sideDistX - deltaDistX;  // Step back one delta to get distance to wall
-        } else {
-            wallDistance = sideDistY - deltaDistY;
-        }
-
-        // Calculate hit point using the actual ray distance (BEFORE fisheye correction)
-        float hitPointX = startX + rayDirectionX * wallDistance;
-        float hitPointY = startY + rayDirectionY * wallDistance;
-
-        // Apply fisheye correction to get perpendicular distance
-        float angleDiff = normalizeAngleDiff(angle - playerAngle);
-        wallDistance = wallDistance * cos(angleDiff);
-
-        RayHit rayHit = RayHit();
-        rayHit.distance = wallDistance;
-        rayHit.hitX = hitPointX;
-        rayHit.hitY = hitPointY;
-        rayHit.angle = angle;
-            
-        // Add bounds check before accessing worldMap
-        if (currentMapY >= 0 && currentMapY < worldMap.size() && 
-            currentMapX >= 0 && currentMapX < worldMap[0].size()) {
-            rayHit.wallType = worldMap[currentMapY][currentMapX];
-        } else {
-            rayHit.wallType = 1;  // Default wall type for out of bounds
+        // The field is 0 exactly on walls, so the map itself is only read for the hit
+        if (freeRadius[cellIndex] == 0) {
+            hitWall = true;
+            break;
         }
-        
-        rayHit.hitVerticalWall = (hitSide == WallType::VERTICAL);
-        return rayHit;
     }
 
-public:
-    Raycaster(WorldMap worldMapObj) {
-        worldMap = worldMapObj.getMap();
+    float wallDistance = hitWall ? distance : maxRayDistance;
+
+    rayHit.distance = wallDistance;
+    rayHit.hitX = startX + rayDirectionX * wallDistance;
+    rayHit.hitY = startY + rayDirectionY * wallDistance;
+    rayHit.wallType = hitWall ? cells[cellIndex] : 0;
+    rayHit.hitVerticalWall = (hitSide == WallType::VERTICAL);
+    return rayHit;
+}
+
+void Raycaster::tracePacket(float startX, float startY, const float* dirX, const float* dirY, RayPacketHits& hits) const {
+    const MapGrid& grid = worldMap.getGrid();
+
+    RayPacketQuery query;
+    query.cells = grid.data();
+    query.stride = grid.getStride();
+    query.startCellX = floor(startX);
+    query.startCellY = floor(startY);
+    query.startIndex = grid.index(query.startCellX, query.startCellY);
+    query.startX = startX;
+    query.startY = startY;
+    query.maxDistance = maxRayDistance;
+    query.dirX = dirX;
+    query.dirY = dirY;
+
+#if defined(RAYCASTER_AVX2_KERNEL)
+    if (packetLanes == 8) {
+        castRayPacket8(query, hits);
+    } else
+#endif
+    {
+        castRayPacket4(query, hits);
+    }
+}
+
+void Raycaster::castPacket(float startX, float startY, const float* dirX, const float* dirY, RayHit* rayResults, uint64_t& steps) const {
+    RayPacketHits hits;
+    tracePacket(startX, startY, dirX, dirY, hits);
+
+    for (int lane = 0; lane < packetLanes; lane++) {
+        RayHit& rayHit = rayResults[lane];
+        rayHit.distance = hits.distance[lane];
+        rayHit.hitX = hits.hitX[lane];
+        rayHit.hitY = hits.hitY[lane];
+        rayHit.wallType = hits.wallType[lane];
+        rayHit.hitVerticalWall = hits.hitVerticalWall[lane] != 0;
+        rayHit.rayDirX = dirX[lane];
+        rayHit.rayDirY = dirY[lane];
+        steps += hits.steps[lane];
+    }
+}
+
+int Raycaster::reuseTurnedColumns(float startX, float startY, float dirX, float dirY, float playerAngle,
+                       int screenWidth, RayHit* rayResults) {
+    // Turn since the cached frame, wrapped to [-pi, pi]
+    float turn = remainder(playerAngle - cachedAngle, 2.0f * static_cast<float>(M_PI));
+    float fieldOfView = columnTableFOV * static_cast<float>(M_PI / 180.0);
+    if (screenWidth < 2 || abs(turn) >= fieldOfView) {
+        addCastTasks(0, screenWidth);
+        return 0;
+    }
+
+    const float* bearings = columnBearings.data();
+    const float* oldBearings = cachedBearings.data();
+    nextBearings.resize(screenWidth);
+
+    int reused = 0;
+    int runStart = -1;
+    int nearest = 0;
+    for (int x = 0; x < screenWidth; x++) {
+        // This column's bearing measured from the cached view direction
+        float bearing = bearings[x] + turn;
+        while (nearest + 1 < screenWidth && abs(oldBearings[nearest + 1] - bearing) <= abs(oldBearings[nearest] - bearing)) {
+            nearest++;
+        }
+
+        int neighbour = x + 1 < screenWidth ? x + 1 : x - 1;
+        float column = abs(bearings[neighbour] - bearings[x]);
+
+        bool reuse = false;
+        if (abs(oldBearings[nearest] - bearing) <= column && !staleColumns[nearest]) {
+            RayHit hit = cachedHits[nearest];
+            float offsetX = hit.hitX - startX;
+            float offsetY = hit.hitY - startY;
+            float distance = offsetX * dirX + offsetY * dirY;
+            if (distance > 0.001f) {
+                float inverseDistance = 1.0f / distance;
+                hit.distance = distance;
+                hit.rayDirX = offsetX * inverseDistance;
+                hit.rayDirY = offsetY * inverseDistance;
+                rayResults[x] = hit;
+                nextBearings[x] = oldBearings[nearest] - turn;
+                reuse = true;
+            }
+        }
+
+        if (reuse) {
+            reused++;
+            if (runStart >= 0) {
+                addCastTasks(runStart, x);
+                runStart = -1;
+            }
+        } else {
+            nextBearings[x] = bearings[x];
+            if (runStart < 0) {
+                runStart = x;
+            }
+        }
+    }
+    if (runStart >= 0) {
+        addCastTasks(runStart, screenWidth);
+    }
+    return reused;
+}
+
+void Raycaster::queueStaleColumns(int screenWidth) {
+    nextBearings.assign(cachedBearings.begin(), cachedBearings.end());
+    int runStart = -1;
+    for (int x = 0; x < screenWidth; x++) {
+        if (staleColumns[x]) {
+            nextBearings[x] = columnBearings[x];
+            if (runStart < 0) {
+                runStart = x;
+            }
+        } else if (runStart >= 0) {
+            addCastTasks(runStart, x);
+            runStart = -1;
+        }
+    }
+    if (runStart >= 0) {
+        addCastTasks(runStart, screenWidth);
+    }
+}
+
+bool Raycaster::segmentEntersBox(float ax, float ay, float bx, float by,
+                             float minX, float minY, float maxX, float maxY) {
+    float enter = 0.0f;
+    float leave = 1.0f;
+    float start[2] = { ax, ay };
+    float delta[2] = { bx - ax, by - ay };
+    float low[2] = { minX, minY };
+    float high[2] = { maxX, maxY };
+    for (int axis = 0; axis < 2; axis++) {
+        if (delta[axis] == 0.0f) {
+            if (start[axis] < low[axis] || start[axis] > high[axis]) {
+                return false;
+            }
+            continue;
+        }
+        float inverse = 1.0f / delta[axis];
+        float t0 = (low[axis] - start[axis]) * inverse;
+        float t1 = (high[axis] - start[axis]) * inverse;
+        enter = std::max(enter, std::min(t0, t1));
+        leave = std::min(leave, std::max(t0, t1));
+    }
+    return enter <= leave;
+}
+
+void Raycaster::storeCache(float startX, float startY, float playerAngle, int screenWidth, const RayHit* rayResults) {
+    // Carried over hits keep their own bearings, freshly cast columns use the table
+    if (lastReusedColumns > 0) {
+        cachedBearings.swap(nextBearings);
+    } else {
+        cachedBearings.assign(columnBearings.begin(), columnBearings.end());
+    }
+    cachedHits.assign(rayResults, rayResults + screenWidth);
+
+    cachedX = startX;
+    cachedY = startY;
+    cachedAngle = playerAngle;
+    cachedFOV = columnTableFOV;
+    cachedMaxDistance = maxRayDistance;
+    cachedWidth = screenWidth;
+    cachedCells = worldMap.getGrid().data();
+    cachedDistanceField = useSkipping() ? distanceField : nullptr;
+    staleColumns.assign(screenWidth, 0);
+    staleCount = 0;
+    rayCacheValid = true;
+}
+
+void Raycaster::castAllRays(const Player& player, int screenWidth, RayHit* rayResults) {
+    updateColumnTable(screenWidth, player.getFieldOfView());
+
+    // The only trig left per frame: the view direction. The camera plane
+    // is that direction rotated by 90 degrees and scaled per column.
+    float playerAngle = player.getAngle();
+    float dirX = cos(playerAngle);
+    float dirY = sin(playerAngle);
+
+    float startX = player.getX();
+    float startY = player.getY();
+    const float* planeOffsets = columnPlaneOffsets.data();
+
+    int lanes = lanesFrom(startX, startY);
+
+    lastCastSteps.store(0, std::memory_order_relaxed);
+    lastReusedColumns = 0;
+
+    castTasks.clear();
+    if (rayCacheEnabled && cacheMatches(startX, startY, screenWidth)) {
+        if (playerAngle == cachedAngle) {
+            // Nothing moved, the last frame is still exact apart from columns an edit made stale
+            std::copy(cachedHits.begin(), cachedHits.end(), rayResults);
+            lastReusedColumns = screenWidth - staleCount;
+            if (staleCount == 0) {
+                return;
+            }
+            queueStaleColumns(screenWidth);
+        } else {
+            lastReusedColumns = reuseTurnedColumns(startX, startY, dirX, dirY, playerAngle, screenWidth, rayResults);
+        }
+    } else {
+        addCastTasks(0, screenWidth);
     }
 
-    std::vector<RayHit> castAllRays(Player& player, int screenWidth) {
-        std::vector<RayHit> rayResults;
+    auto castColumns = [&](int firstColumn, int endColumn) {
+        float packetDirX[MAX_PACKET_LANES];
+        float packetDirY[MAX_PACKET_LANES];
+        uint64_t steps = 0;
 
-        float playerAngle = player.getAngle();
+        int x = firstColumn;
+        for (; lanes > 1 && x + lanes <= endColumn; x += lanes) {
+            for (int lane = 0; lane < lanes; lane++) {
+                packetDirX[lane] = dirX - dirY * planeOffsets[x + lane];
+                packetDirY[lane] = dirY + dirX * planeOffsets[x + lane];
+            }
+            castPacket(startX, startY, packetDirX, packetDirY, &rayResults[x], steps);
+        }
 
-        // Calculate camera direction and plane vectors
-        float dirX = cos(playerAngle);
-        float dirY = sin(playerAngle);
+        // Columns that don't fill a whole packet take the scalar path
+        for (; x < endColumn; x++) {
+            float rayDirX = dirX - dirY * planeOffsets[x];
+            float rayDirY = dirY + dirX * planeOffsets[x];
 
-        // Camera plane perpendicular to direction (90 degrees rotated)
-        float FOVRadians = player.getFieldOfView() * (M_PI / 180.0f);
-        float planeLength = tan(FOVRadians / 2.0f);
-        float planeX = -dirY * planeLength;
-        float planeY = dirX * planeLength;
+            rayResults[x] = traceRay(startX, startY, rayDirX, rayDirY, steps);
+        }
 
-        for (int x = 0; x < screenWidth; x++) {
-            // Calculate ray position on camera plane (-1 to +1)
-            float cameraX = 2.0f * x / (float)screenWidth - 1.0f;
+        lastCastSteps.fetch_add(steps, std::memory_order_relaxed);
+    };
 
-            // Calculate ray direction
-            float rayDirX = dirX + planeX * cameraX;
-            float rayDirY = dirY + planeY * cameraX;
+    runTasks(static_cast<int>(castTasks.size()), [&](int task) {
+        castColumns(castTasks[task].first, castTasks[task].second);
+    });
 
-            // Normalize ray direction
-            float rayLength = sqrt(rayDirX * rayDirX + rayDirY * rayDirY);
-            rayDirX /= rayLength;
-            rayDirY /= rayLength;
+    if (rayCacheEnabled) {
+        storeCache(startX, startY, playerAngle, screenWidth, rayResults);
+    }
+}
 
-            // Calculate angle for this ray
-            float currentRayAngle = atan2(rayDirY, rayDirX);
+uint64_t Raycaster::castViews(const ViewPose* views, int viewCount, int columnsPerView, RayBatchHits& hits) const {
+    hits.resize(viewCount * columnsPerView);
+    if (viewCount <= 0 || columnsPerView <= 0) {
+        return 0;
+    }
 
-            RayHit rayHit = castSingleRay(player.getX(), player.getY(), currentRayAngle, playerAngle);
+    int tilesPerView = (columnsPerView + tileWidth - 1) / tileWidth;
+    std::atomic<uint64_t> totalSteps(0);
+
+    runTasks(viewCount * tilesPerView, [&](int task) {
+        int viewIndex = task / tilesPerView;
+        const ViewPose& view = views[viewIndex];
+        int firstColumn = (task % tilesPerView) * tileWidth;
+        int endColumn = std::min(firstColumn + tileWidth, columnsPerView);
+        int viewStart = viewIndex * columnsPerView;
+
+        float dirX = cos(view.angle);
+        float dirY = sin(view.angle);
+        float planeLength = planeLengthFor(view.fieldOfView);
+        int lanes = lanesFrom(view.x, view.y);
+
+        float packetDirX[MAX_PACKET_LANES];
+        float packetDirY[MAX_PACKET_LANES];
+        RayPacketHits packet;
+        uint64_t steps = 0;
+
+        int x = firstColumn;
+        for (; lanes > 1 && x + lanes <= endColumn; x += lanes) {
+            for (int lane = 0; lane < lanes; lane++) {
+                float planeOffset = (2.0f * (x + lane) / (float)columnsPerView - 1.0f) * planeLength;
+                packetDirX[lane] = dirX - dirY * planeOffset;
+                packetDirY[lane] = dirY + dirX * planeOffset;
+            }
+            tracePacket(view.x, view.y, packetDirX, packetDirY, packet);
+            hits.store(viewStart + x, packet, lanes);
+            for (int lane = 0; lane < lanes; lane++) {
+                steps += packet.steps[lane];
+            }
+        }
 
-            rayResults.push_back(rayHit);
+        for (; x < endColumn; x++) {
+            float planeOffset = (2.0f * x / (float)columnsPerView - 1.0f) * planeLength;
+            float rayDirX = dirX - dirY * planeOffset;
+            float rayDirY = dirY + dirX * planeOffset;
+            hits.store(viewStart + x, traceRay(view.x, view.y, rayDirX, rayDirY, steps));
         }
-        return rayResults;
+
+        totalSteps.fetch_add(steps, std::memory_order_relaxed);
+    });
+
+    return totalSteps.load(std::memory_order_relaxed);
+}
+
+uint64_t Raycaster::castRays(const float* originX, const float* originY, const float* dirX, const float* dirY,
+                  int count, RayBatchHits& hits) const {
+    hits.resize(count);
+    if (count <= 0) {
+        return 0;
     }
 
-// This doesn't work, Fixed angle incrementation only works if the display is curver around the viewer in real life.  Vector Plane projection fixes this as done above
-/*
-        std::vector<RayHit> rayResults;
+    int taskCount = (count + tileWidth - 1) / tileWidth;
+    std::atomic<uint64_t> totalSteps(0);
 
-        float FOVRadians = player.getFieldOfView() * (M_PI / 180.0f);
+    runTasks(taskCount, [&](int task) {
+        int first = task * tileWidth;
+        int end = std::min(first + tileWidth, count);
 
-        float angleStep = FOVRadians / screenWidth;
-        float startAngle = player.getAngle() - FOVRadians/2;
+        RayPacketHits packet;
+        uint64_t steps = 0;
 
-        for (int i = 0; i < screenWidth; i++) {
-            float currentRayAngle = startAngle + (i * angleStep);
+        int i = first;
+        while (i < end) {
+            int lanes = lanesFrom(originX[i], originY[i]);
+            bool sharedOrigin = lanes > 1 && i + lanes <= end;
+            for (int lane = 1; sharedOrigin && lane < lanes; lane++) {
+                sharedOrigin = originX[i + lane] == originX[i] && originY[i + lane] == originY[i];
+            }
 
-            RayHit rayHit = castSingleRay(player.getX(), player.getY(), currentRayAngle, player.getAngle());
+            if (sharedOrigin) {
+                tracePacket(originX[i], originY[i], dirX + i, dirY + i, packet);
+                hits.store(i, packet, lanes);
+                for (int lane = 0; lane < lanes; lane++) {
+                    steps += packet.steps[lane];
+                }
+                i += lanes;
+            } else {
+                hits.store(i, traceRay(originX[i], originY[i], dirX[i], dirY[i], steps));
+                i++;
+            }
+        }
+
+        totalSteps.fetch_add(steps, std::memory_order_relaxed);
+    });
+
+    return totalSteps.load(std::memory_order_relaxed);
+}
 
-            rayResults.push_back(rayHit);
+void Raycaster::testLinesOfSight(const float* ax, const float* ay, const float* bx, const float* by,
+                      int count, uint8_t* visible) const {
+    runTasks((count + SEGMENTS_PER_TASK - 1) / SEGMENTS_PER_TASK, [&](int task) {
+        int end = std::min((task + 1) * SEGMENTS_PER_TASK, count);
+        for (int i = task * SEGMENTS_PER_TASK; i < end; i++) {
+            visible[i] = worldMap.hasLineOfSight(ax[i], ay[i], bx[i], by[i]) ? 1 : 0;
+        }
+    });
+}
+
+void Raycaster::findWallsOnSegments(const float* ax, const float* ay, const float* bx, const float* by,
+                         int count, SegmentHit* hits) const {
+    runTasks((count + SEGMENTS_PER_TASK - 1) / SEGMENTS_PER_TASK, [&](int task) {
+        int end = std::min((task + 1) * SEGMENTS_PER_TASK, count);
+        for (int i = task * SEGMENTS_PER_TASK; i < end; i++) {
+            worldMap.findWallOnSegment(ax[i], ay[i], bx[i], by[i], hits[i]);
+        }
+    });
+}
+
+void Raycaster::invalidateRayCacheRegion(const CellRect& cells) {
+    if (!rayCacheValid || cells.empty()) {
+        return;
+    }
+    const float margin = 1.0f / 1024.0f;
+    float minX = cells.x0 - margin;
+    float minY = cells.y0 - margin;
+    float maxX = cells.x1 + margin;
+    float maxY = cells.y1 + margin;
+    for (int x = 0; x < cachedWidth; x++) {
+        if (!staleColumns[x] && segmentEntersBox(cachedX, cachedY, cachedHits[x].hitX, cachedHits[x].hitY,
+                                                 minX, minY, maxX, maxY)) {
+            staleColumns[x] = 1;
+            staleCount++;
         }
-        return rayResults;
     }
-*/
-    void setMaxDistance(float distance){ maxRayDistance = distance; }
-};
\ No newline at end of file
+}
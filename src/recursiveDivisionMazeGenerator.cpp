@@ -1,8 +1,7 @@
-#pragma once
-
 #include "recursiveDivisionMazeGenerator.h"
 #include <iostream>
 #include <ctime>
+#include <algorithm>
 
 // Point class implementation
 Point::Point(int yCoord, int xCoord) : y(yCoord), x(xCoord) {}
@@ -69,7 +68,7 @@ std::vector<Rectangle> Rectangle::split(const Division& division) const {
 
 // RecursiveDivisionMazeGenerator class implementation
 RecursiveDivisionMazeGenerator::RecursiveDivisionMazeGenerator(int w, int h, int seed) 
-    : width(w), height(h), rng(seed == 0 ? RandomNumberGenerator() : RandomNumberGenerator(seed)) {
+    : width(w), height(h), rng(seed == 0 ? RandomNumberGenerator() : RandomNumberGenerator(seed)), seed(seed) {
     if (width % 2 == 0) width++;
     if (height % 2 == 0) height++;
 }
@@ -145,6 +144,53 @@ void RecursiveDivisionMazeGenerator::createPassage(const Division& division) {
 
 void RecursiveDivisionMazeGenerator::generateMaze() {
     initializeGrid();
+
+    // No chamber is ever pending for more than one level of the split, so
+    // this bounds the stack and it never has to grow during generation
+    chamberStack.clear();
+    chamberStack.reserve(width + height);
+    chamberStack.push_back(Rectangle(1, 1, width - 2, height - 2));
+
+    while (!chamberStack.empty()) {
+        Rectangle chamber = chamberStack.back();
+        chamberStack.pop_back();
+
+        if (!chamber.canSubdivide()) {
+            continue;
+        }
+
+        // Same random calls in the same order as createDivision, so both paths match
+        if (chooseDivisionOrientation(chamber) == Orientation::HORIZONTAL) {
+            int lineY = rng.randomOdd(chamber.y + 1, chamber.y + chamber.height - 2);
+            int passageX = rng.randomEven(chamber.x, chamber.x + chamber.width - 1);
+
+            // A horizontal wall is one contiguous run of the row
+            std::fill_n(maze[lineY].begin() + chamber.x, chamber.width, static_cast<int>(CellType::WALL));
+            maze[lineY][passageX] = CellType::PASSAGE;
+
+            // Pushed in reverse so the top chamber is divided first, as the recursion does
+            chamberStack.push_back(Rectangle(chamber.x, lineY + 1, chamber.width, (chamber.y + chamber.height) - (lineY + 1)));
+            chamberStack.push_back(Rectangle(chamber.x, chamber.y, chamber.width, lineY - chamber.y));
+        } else {
+            int lineX = rng.randomOdd(chamber.x + 1, chamber.x + chamber.width - 2);
+            int passageY = rng.randomEven(chamber.y, chamber.y + chamber.height - 1);
+
+            for (int y = chamber.y; y < chamber.y + chamber.height; y++) {
+                maze[y][lineX] = CellType::WALL;
+            }
+            maze[passageY][lineX] = CellType::PASSAGE;
+
+            chamberStack.push_back(Rectangle(lineX + 1, chamber.y, (chamber.x + chamber.width) - (lineX + 1), chamber.height));
+            chamberStack.push_back(Rectangle(chamber.x, chamber.y, lineX - chamber.x, chamber.height));
+        }
+    }
+
+    maze[1][0] = CellType::PASSAGE;
+    maze[height - 2][width - 1] = CellType::PASSAGE;
+}
+
+void RecursiveDivisionMazeGenerator::generateMazeRecursive() {
+    initializeGrid();
     subdivide(Rectangle(1, 1, width - 2, height - 2));
 
     maze[1][0] = CellType::PASSAGE;
@@ -198,4 +244,8 @@ int RecursiveDivisionMazeGenerator::getHeight() const {
 
 const std::vector<std::vector<int>>& RecursiveDivisionMazeGenerator::getMaze() const { 
     return maze; 
-}
\ No newline at end of file
+}
+
+bool RecursiveDivisionMazeGenerator::writeBinary(const std::string& path, MazeFileEncoding encoding) const {
+    return writeMazeFile(path, maze, MazeFileGenerator::RECURSIVE_DIVISION, static_cast<uint32_t>(seed), encoding);
+}
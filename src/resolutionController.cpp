@@ -0,0 +1,19 @@
+#include "resolutionController.h"
+
+void ResolutionController::update(double frameMs) {
+    if (!enabled || frameMs <= 0.0) {
+        return;
+    }
+
+    smoothedMs = smoothedMs > 0.0 ? smoothedMs + SMOOTHING * (frameMs - smoothedMs) : frameMs;
+    if (++framesSinceChange < SETTLE_FRAMES) {
+        return;
+    }
+
+    if (smoothedMs > targetMs && level + 1 < LEVEL_COUNT) {
+        setLevel(level + 1);
+    } else if (level > 0 &&
+               smoothedMs * pixelShare(level - 1) / pixelShare(level) < targetMs * RAISE_HEADROOM) {
+        setLevel(level - 1);
+    }
+}
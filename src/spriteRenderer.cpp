@@ -0,0 +1,210 @@
+#include "spriteRenderer.h"
+
+const int32_t* SpriteRenderer::sortFarToNear(int count) {
+    uint32_t* keys = sortKeys.data();
+    uint32_t* keysOut = sortKeysScratch.data();
+    int32_t* order = drawOrder.data();
+    int32_t* orderOut = drawOrderScratch.data();
+
+    uint32_t histograms[4][256] = {};
+    for (int i = 0; i < count; i++) {
+        order[i] = i;
+        for (int pass = 0; pass < 4; pass++) {
+            histograms[pass][(keys[i] >> (pass * 8)) & 0xff]++;
+        }
+    }
+
+    for (int pass = 0; pass < 4; pass++) {
+        uint32_t* histogram = histograms[pass];
+        int shift = pass * 8;
+        if (histogram[(keys[0] >> shift) & 0xff] == static_cast<uint32_t>(count)) {
+            continue;
+        }
+
+        uint32_t offset = 0;
+        for (int digit = 0; digit < 256; digit++) {
+            uint32_t digitCount = histogram[digit];
+            histogram[digit] = offset;
+            offset += digitCount;
+        }
+        for (int i = 0; i < count; i++) {
+            uint32_t slot = histogram[(keys[i] >> shift) & 0xff]++;
+            keysOut[slot] = keys[i];
+            orderOut[slot] = order[i];
+        }
+        std::swap(keys, keysOut);
+        std::swap(order, orderOut);
+    }
+    return order;
+}
+
+void SpriteRenderer::draw(uint32_t* pixels, int pitch, int width, int height, const float* columnDepths,
+          const SpritePool& sprites, float cameraX, float cameraY, float angle, float fieldOfView,
+          float projectionScale) {
+    lastVisible = 0;
+    int count = sprites.size();
+    if (width <= 0 || height <= 0 || count == 0) {
+        return;
+    }
+    if (static_cast<int>(projected.size()) < count) {
+        candidates.resize(count);
+        projected.resize(count);
+        sortKeys.resize(count);
+        sortKeysScratch.resize(count);
+        drawOrder.resize(count);
+        drawOrderScratch.resize(count);
+    }
+
+    float dirX = cos(angle);
+    float dirY = sin(angle);
+    float FOVRadians = fieldOfView * (M_PI / 180.0f);
+    float planeLength = tan(FOVRadians / 2.0f);
+
+    // Pixels per unit of sideways offset over depth, across and down
+    float columnScale = width / (2.0f * planeLength);
+    float horizon = height / 2.0f;
+
+    // Farthest wall in each block of columns, anything behind it in every block it covers is hidden
+    int blockCount = (width + OCCLUSION_BLOCK - 1) / OCCLUSION_BLOCK;
+    blockDepths.resize(blockCount);
+    float farthestWall = 0.0f;
+    for (int block = 0; block < blockCount; block++) {
+        int end = std::min((block + 1) * OCCLUSION_BLOCK, width);
+        float farthest = 0.0f;
+        for (int x = block * OCCLUSION_BLOCK; x < end; x++) {
+            farthest = std::max(farthest, columnDepths[x]);
+        }
+        blockDepths[block] = farthest;
+        farthestWall = std::max(farthestWall, farthest);
+    }
+
+    // Frustum and far plane cull without branching on the result, which is close to a coin toss per sprite
+    const float* spriteX = sprites.x.data();
+    const float* spriteY = sprites.y.data();
+    const float* spriteScale = sprites.scale.data();
+    int32_t* inFrustum = candidates.data();
+    int candidateCount = 0;
+    for (int i = 0; i < count; i++) {
+        float relativeX = spriteX[i] - cameraX;
+        float relativeY = spriteY[i] - cameraY;
+        float depth = relativeX * dirX + relativeY * dirY;
+        float side = relativeY * dirX - relativeX * dirY;
+        float halfWidth = spriteScale[i] * 0.5f;
+        inFrustum[candidateCount] = i;
+        candidateCount += (depth >= NEAR_DISTANCE) & (depth < farthestWall) &
+                          (fabs(side) - halfWidth < depth * planeLength);
+    }
+
+    int visible = 0;
+    for (int candidate = 0; candidate < candidateCount; candidate++) {
+        int i = inFrustum[candidate];
+        float relativeX = spriteX[i] - cameraX;
+        float relativeY = spriteY[i] - cameraY;
+        float depth = relativeX * dirX + relativeY * dirY;
+        float side = relativeY * dirX - relativeX * dirY;
+
+        float inverseDepth = 1.0f / depth;
+        float spriteWidth = spriteScale[i] * inverseDepth * columnScale;
+        float spriteHeight = spriteScale[i] * inverseDepth * projectionScale;
+        float left = (side * inverseDepth + planeLength) * columnScale - spriteWidth * 0.5f;
+        float top = horizon + projectionScale * 0.5f * inverseDepth - spriteHeight;
+
+        // Pixels whose centres fall inside the sprite
+        int firstColumn = std::max(static_cast<int>(ceil(left - 0.5f)), 0);
+        int endColumn = std::min(static_cast<int>(ceil(left + spriteWidth - 0.5f)), width);
+        int firstRow = std::max(static_cast<int>(ceil(top - 0.5f)), 0);
+        int endRow = std::min(static_cast<int>(ceil(top + spriteHeight - 0.5f)), height);
+        if (firstColumn >= endColumn || firstRow >= endRow) {
+            continue;
+        }
+
+        // Trim blocks hidden behind walls off both ends, dropping the sprite if none are left
+        int firstBlock = firstColumn / OCCLUSION_BLOCK;
+        int lastBlock = (endColumn - 1) / OCCLUSION_BLOCK;
+        while (firstBlock <= lastBlock && depth >= blockDepths[firstBlock]) {
+            firstBlock++;
+        }
+        while (lastBlock >= firstBlock && depth >= blockDepths[lastBlock]) {
+            lastBlock--;
+        }
+        if (firstBlock > lastBlock) {
+            continue;
+        }
+        firstColumn = std::max(firstColumn, firstBlock * OCCLUSION_BLOCK);
+        endColumn = std::min(endColumn, (lastBlock + 1) * OCCLUSION_BLOCK);
+
+        int level = SpriteTextureAtlas::mipLevelFor(std::min(spriteWidth, spriteHeight));
+        float textureSize = static_cast<float>(SpriteTextureAtlas::TEXTURE_SIZE >> level);
+
+        uint32_t depthBits;
+        std::memcpy(&depthBits, &depth, sizeof(depthBits));
+        sortKeys[visible] = ~depthBits;
+
+        ProjectedSprite& sprite = projected[visible++];
+        sprite.depth = depth;
+        sprite.left = left;
+        sprite.top = top;
+        sprite.texelsPerColumn = textureSize / spriteWidth;
+        sprite.texelsPerRow = textureSize / spriteHeight;
+        sprite.firstColumn = firstColumn;
+        sprite.endColumn = endColumn;
+        sprite.firstRow = firstRow;
+        sprite.endRow = endRow;
+        sprite.level = level;
+        sprite.type = sprites.type[i];
+    }
+    lastVisible = visible;
+    if (visible == 0) {
+        return;
+    }
+
+    const int32_t* order = sortFarToNear(visible);
+
+    auto drawColumns = [&](int task) {
+        int firstColumn = task * COLUMNS_PER_TASK;
+        int endColumn = std::min(firstColumn + COLUMNS_PER_TASK, width);
+
+        for (int k = 0; k < visible; k++) {
+            const ProjectedSprite& sprite = projected[order[k]];
+            int begin = std::max(sprite.firstColumn, firstColumn);
+            int end = std::min(sprite.endColumn, endColumn);
+            if (begin >= end) {
+                continue;
+            }
+
+            int size = SpriteTextureAtlas::TEXTURE_SIZE >> sprite.level;
+            const uint32_t* texture = textures.texture(sprite.type, sprite.level);
+            uint32_t vStep = static_cast<uint32_t>(sprite.texelsPerRow * 65536.0f);
+            uint32_t vMask = static_cast<uint32_t>(size - 1);
+            float rowsPerTexel = 1.0f / sprite.texelsPerRow;
+
+            for (int x = begin; x < end; x++) {
+                if (sprite.depth >= columnDepths[x]) {
+                    continue;
+                }
+                int texelU = std::min(static_cast<int>((x + 0.5f - sprite.left) * sprite.texelsPerColumn), size - 1);
+
+                // Only the rows whose centres land on the column's solid texels
+                const uint8_t* span = textures.solidSpan(sprite.type, sprite.level, texelU);
+                int firstRow = std::max(static_cast<int>(ceil(sprite.top + span[0] * rowsPerTexel - 0.5f)), sprite.firstRow);
+                int endRow = std::min(static_cast<int>(ceil(sprite.top + span[1] * rowsPerTexel - 0.5f)), sprite.endRow);
+                if (firstRow >= endRow) {
+                    continue;
+                }
+
+                // 16.16 fixed point V, sampled at the centre of each screen row
+                uint32_t v = static_cast<uint32_t>(std::max((firstRow + 0.5f - sprite.top) * sprite.texelsPerRow, 0.0f) * 65536.0f);
+                drawStrip(pixels + x, pitch, firstRow, endRow, texture + texelU * size, v, vStep, vMask);
+            }
+        }
+    };
+
+    int taskCount = (width + COLUMNS_PER_TASK - 1) / COLUMNS_PER_TASK;
+    if (!threadPool || taskCount <= 1) {
+        for (int task = 0; task < taskCount; task++) {
+            drawColumns(task);
+        }
+        return;
+    }
+    threadPool->parallelFor(taskCount, drawColumns);
+}
@@ -0,0 +1,107 @@
+#include "spriteTextures.h"
+
+uint32_t SpriteTextureAtlas::generateTexel(int type, int u, int v) {
+    // Centre of the texel relative to the middle of the texture, in [-1, 1]
+    float px = (u + 0.5f) / (TEXTURE_SIZE / 2) - 1.0f;
+    float py = (v + 0.5f) / (TEXTURE_SIZE / 2) - 1.0f;
+
+    switch (type) {
+        case SPRITE_PICKUP: {
+            // Gold coin resting on the floor, darker rim
+            float dx = px;
+            float dy = (py - 0.55f) * 2.2f;
+            float radius = sqrt(dx * dx + dy * dy) / 0.42f;
+            if (radius > 1.0f) {
+                return 0;
+            }
+            float tone = radius > 0.8f ? 0.7f : 1.0f - 0.25f * (dx + dy);
+            return packColor(static_cast<int>(240 * tone), static_cast<int>(190 * tone), static_cast<int>(40 * tone));
+        }
+        case SPRITE_HEALTH: {
+            // Red cross on a white box, sitting on the floor
+            if (fabs(px) > 0.4f || py < 0.2f || py > 1.0f) {
+                return 0;
+            }
+            float cy = py - 0.6f;
+            bool cross = (fabs(px) < 0.1f && fabs(cy) < 0.3f) || (fabs(cy) < 0.1f && fabs(px) < 0.3f);
+            if (cross) {
+                return packColor(200, 30, 30);
+            }
+            int shade = fabs(px) > 0.36f || py < 0.24f ? 170 : 235;
+            return packColor(shade, shade, shade);
+        }
+        default: {
+            // Green figure: round head over a wider body, two eyes
+            float headY = py + 0.45f;
+            bool head = px * px + headY * headY < 0.25f * 0.25f;
+            float bodyHalfWidth = 0.2f + 0.2f * (py + 0.2f);
+            bool body = py > -0.2f && py < 1.0f && fabs(px) < bodyHalfWidth;
+            if (!head && !body) {
+                return 0;
+            }
+            bool eye = head && fabs(headY + 0.03f) < 0.05f && fabs(fabs(px) - 0.1f) < 0.05f;
+            if (eye) {
+                return packColor(20, 20, 20);
+            }
+            float tone = 0.8f + 0.2f * px;
+            return packColor(static_cast<int>(60 * tone), static_cast<int>(170 * tone), static_cast<int>(70 * tone));
+        }
+    }
+}
+
+void SpriteTextureAtlas::build() {
+    int offset = 0;
+    int columnOffset = 0;
+    for (int level = 0; level < MIP_LEVELS; level++) {
+        levelOffsets[level] = offset;
+        levelColumnOffsets[level] = columnOffset;
+        int size = TEXTURE_SIZE >> level;
+        offset += size * size;
+        columnOffset += size;
+    }
+
+    texels.assign(static_cast<size_t>(TEXELS_PER_TEXTURE) * SPRITE_TYPE_COUNT, 0);
+    for (int type = 0; type < SPRITE_TYPE_COUNT; type++) {
+        uint32_t* top = writableTexture(type, 0);
+        for (int u = 0; u < TEXTURE_SIZE; u++) {
+            for (int v = 0; v < TEXTURE_SIZE; v++) {
+                top[u * TEXTURE_SIZE + v] = generateTexel(type, u, v);
+            }
+        }
+
+        for (int level = 1; level < MIP_LEVELS; level++) {
+            const uint32_t* above = writableTexture(type, level - 1);
+            uint32_t* below = writableTexture(type, level);
+            int size = TEXTURE_SIZE >> level;
+            int aboveSize = size * 2;
+            for (int u = 0; u < size; u++) {
+                for (int v = 0; v < size; v++) {
+                    const uint32_t* left = above + (2 * u) * aboveSize + 2 * v;
+                    const uint32_t* right = left + aboveSize;
+                    below[u * size + v] = average(left[0], left[1], right[0], right[1]);
+                }
+            }
+        }
+    }
+
+    solidSpans.assign(static_cast<size_t>(COLUMNS_PER_TEXTURE) * SPRITE_TYPE_COUNT * 2, 0);
+    for (int type = 0; type < SPRITE_TYPE_COUNT; type++) {
+        for (int level = 0; level < MIP_LEVELS; level++) {
+            int size = TEXTURE_SIZE >> level;
+            for (int u = 0; u < size; u++) {
+                const uint32_t* strip = texture(type, level) + u * size;
+                int first = 0;
+                int end = size;
+                while (first < end && !(strip[first] & OPAQUE)) {
+                    first++;
+                }
+                while (end > first && !(strip[end - 1] & OPAQUE)) {
+                    end--;
+                }
+                uint8_t* span = &solidSpans[(static_cast<size_t>(type) * COLUMNS_PER_TEXTURE + levelColumnOffsets[level] + u) * 2];
+                span[0] = static_cast<uint8_t>(first);
+                span[1] = static_cast<uint8_t>(end);
+            }
+        }
+    }
+}
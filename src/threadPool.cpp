@@ -0,0 +1,76 @@
+#include "threadPool.h"
+
+void ThreadPool::runTasks() {
+    int task;
+    while ((task = nextTask.fetch_add(1, std::memory_order_relaxed)) < jobTaskCount) {
+        jobInvoke(jobContext, task);
+    }
+}
+
+void ThreadPool::workerLoop() {
+    uint64_t seenGeneration = 0;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            wakeWorkers.wait(lock, [&] { return stopping || jobGeneration != seenGeneration; });
+            if (stopping) {
+                return;
+            }
+            seenGeneration = jobGeneration;
+        }
+
+        runTasks();
+
+        std::lock_guard<std::mutex> lock(mutex);
+        if (--activeWorkers == 0) {
+            jobDone.notify_one();
+        }
+    }
+}
+
+void ThreadPool::run(void (*invoke)(void*, int), void* context, int taskCount) {
+    if (workers.empty() || taskCount <= 1) {
+        for (int task = 0; task < taskCount; task++) {
+            invoke(context, task);
+        }
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        jobInvoke = invoke;
+        jobContext = context;
+        jobTaskCount = taskCount;
+        nextTask.store(0, std::memory_order_relaxed);
+        activeWorkers = static_cast<int>(workers.size());
+        jobGeneration++;
+    }
+    wakeWorkers.notify_all();
+
+    runTasks();
+
+    std::unique_lock<std::mutex> lock(mutex);
+    jobDone.wait(lock, [&] { return activeWorkers == 0; });
+}
+
+ThreadPool::ThreadPool(int threadCount)
+    : jobInvoke(nullptr), jobContext(nullptr), jobTaskCount(0), nextTask(0),
+      activeWorkers(0), jobGeneration(0), stopping(false) {
+    if (threadCount <= 0) {
+        threadCount = static_cast<int>(std::thread::hardware_concurrency());
+    }
+    for (int i = 1; i < threadCount; i++) {
+        workers.emplace_back(&ThreadPool::workerLoop, this);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wakeWorkers.notify_all();
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
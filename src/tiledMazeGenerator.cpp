@@ -0,0 +1,196 @@
+#include "tiledMazeGenerator.h"
+#include "depthFirstMazeGenerator.h"
+#include "recursiveDivisionMazeGenerator.h"
+#include "threadPool.h"
+#include <algorithm>
+#include <ctime>
+
+TiledMazeGenerator::TiledMazeGenerator(int w, int h, unsigned int seed, TiledMazeAlgorithm algorithm, int tileSize)
+    : width(w), height(h), tileSize(tileSize), algorithm(algorithm), threadPool(nullptr) {
+    if (width % 2 == 0) width++;
+    if (height % 2 == 0) height++;
+    if (this->tileSize % 2 == 0) this->tileSize++;
+    this->tileSize = std::max(this->tileSize, 5);
+
+    // Tiles step by tileSize - 1 since neighbours share their edge wall.
+    // The last tile in each direction also takes the leftover cells, so
+    // there is never a sliver tile too thin to hold a seam.
+    int step = this->tileSize - 1;
+    tilesX = std::max(1, (width - 1) / step);
+    tilesY = std::max(1, (height - 1) / step);
+
+    // Resolve the time seed once so every tile derives from the same value
+    masterSeed = seed == 0 ? static_cast<uint32_t>(std::time(nullptr)) : seed;
+}
+
+void TiledMazeGenerator::setThreadPool(ThreadPool* pool) {
+    threadPool = pool;
+}
+
+int TiledMazeGenerator::tileStartX(int tileX) const { return tileX * (tileSize - 1); }
+int TiledMazeGenerator::tileStartY(int tileY) const { return tileY * (tileSize - 1); }
+int TiledMazeGenerator::tileEndX(int tileX) const { return tileX == tilesX - 1 ? width - 1 : tileStartX(tileX) + tileSize - 1; }
+int TiledMazeGenerator::tileEndY(int tileY) const { return tileY == tilesY - 1 ? height - 1 : tileStartY(tileY) + tileSize - 1; }
+
+/**
+ * @brief Seed for one tile, a SplitMix64 hash of the master seed and tile index
+ *
+ * Neighbouring tile indices give unrelated seeds, and 0 is avoided since
+ * the generators treat it as "seed from the clock".
+ */
+unsigned int TiledMazeGenerator::childSeed(int tileIndex) const {
+    uint64_t z = (static_cast<uint64_t>(masterSeed) << 32 | static_cast<uint32_t>(tileIndex)) + 0x9E3779B97F4A7C15ull;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    z ^= z >> 31;
+    unsigned int seed = static_cast<unsigned int>(z);
+    return seed == 0 ? 1 : seed;
+}
+
+/**
+ * @brief Generate one tile and copy its interior into the maze
+ *
+ * Tile sizes are always odd (the maze and tile step are even offsets from
+ * an odd size), so both generators get the dimensions they expect. Edge
+ * walls, including each tile's own entrance and exit, are left to the
+ * shared all-wall initialisation.
+ */
+void TiledMazeGenerator::generateTile(int tileIndex) {
+    int tileX = tileIndex % tilesX;
+    int tileY = tileIndex / tilesX;
+    int x0 = tileStartX(tileX);
+    int y0 = tileStartY(tileY);
+    int tileWidth = tileEndX(tileX) - x0 + 1;
+    int tileHeight = tileEndY(tileY) - y0 + 1;
+
+    auto copyInterior = [&](const std::vector<std::vector<int>>& tile) {
+        for (int y = 1; y < tileHeight - 1; y++) {
+            std::copy(tile[y].begin() + 1, tile[y].begin() + (tileWidth - 1), maze[y0 + y].begin() + (x0 + 1));
+        }
+    };
+
+    if (algorithm == TiledMazeAlgorithm::DEPTH_FIRST) {
+        DepthFirstMazeGenerator generator(tileWidth, tileHeight, childSeed(tileIndex));
+        generator.generateMaze();
+        copyInterior(generator.getMaze());
+    } else {
+        RecursiveDivisionMazeGenerator generator(tileWidth, tileHeight, static_cast<int>(childSeed(tileIndex)));
+        generator.generateMaze();
+        copyInterior(generator.getMaze());
+    }
+}
+
+/**
+ * @brief Offset along a shared edge wall for a seam passage
+ *
+ * Depth-first tiles always have open cells at odd offsets. Recursive
+ * division only ever builds walls on odd lines, so its cells at even
+ * offsets are always open. The first and last interior rows never hold a
+ * wall either way, so the cells on both sides of the seam are open.
+ *
+ * @param edgeLength Length of the edge including the corner walls, odd and at least 5
+ */
+int TiledMazeGenerator::pickSeamOffset(RandomNumberGenerator& rng, int edgeLength) {
+    if (algorithm == TiledMazeAlgorithm::DEPTH_FIRST) {
+        return rng.randomOdd(1, edgeLength - 2);
+    }
+    return rng.randomEven(2, edgeLength - 3);
+}
+
+/**
+ * @brief Join the tiles along a random spanning tree
+ *
+ * Depth-first search over the tile grid with the master seed, opening one
+ * cell in the shared wall of every tile pair the search steps across.
+ */
+void TiledMazeGenerator::carveSeams() {
+    RandomNumberGenerator rng(masterSeed);
+    const int dx[4] = {0, 1, 0, -1};
+    const int dy[4] = {-1, 0, 1, 0};
+
+    std::vector<char> visited(static_cast<size_t>(tilesX) * tilesY, 0);
+    std::vector<int> stack;
+    std::vector<int> directions = {0, 1, 2, 3};
+    visited[0] = 1;
+    stack.push_back(0);
+
+    while (!stack.empty()) {
+        int current = stack.back();
+        int tileX = current % tilesX;
+        int tileY = current / tilesX;
+
+        rng.shuffle(directions);
+        bool moved = false;
+        for (int dir : directions) {
+            int nextX = tileX + dx[dir];
+            int nextY = tileY + dy[dir];
+            if (nextX < 0 || nextX >= tilesX || nextY < 0 || nextY >= tilesY) {
+                continue;
+            }
+            int next = nextY * tilesX + nextX;
+            if (visited[next]) {
+                continue;
+            }
+
+            if (dx[dir] != 0) {
+                // Vertical wall shared by horizontal neighbours
+                int wallX = tileStartX(std::max(tileX, nextX));
+                int y0 = tileStartY(tileY);
+                maze[y0 + pickSeamOffset(rng, tileEndY(tileY) - y0 + 1)][wallX] = 0;
+            } else {
+                int wallY = tileStartY(std::max(tileY, nextY));
+                int x0 = tileStartX(tileX);
+                maze[wallY][x0 + pickSeamOffset(rng, tileEndX(tileX) - x0 + 1)] = 0;
+            }
+
+            visited[next] = 1;
+            stack.push_back(next);
+            moved = true;
+            break;
+        }
+
+        if (!moved) {
+            stack.pop_back();
+        }
+    }
+}
+
+void TiledMazeGenerator::generateMaze() {
+    maze.assign(height, std::vector<int>(width, 1));
+
+    int tileCount = tilesX * tilesY;
+    if (threadPool) {
+        threadPool->parallelFor(tileCount, [this](int tileIndex) { generateTile(tileIndex); });
+    } else {
+        for (int tileIndex = 0; tileIndex < tileCount; tileIndex++) {
+            generateTile(tileIndex);
+        }
+    }
+
+    carveSeams();
+
+    // Same entrance and exit as the underlying generator would make
+    int marker = algorithm == TiledMazeAlgorithm::DEPTH_FIRST ? 2 : 0;
+    maze[1][0] = marker;
+    maze[height - 2][width - 1] = marker;
+}
+
+int TiledMazeGenerator::getWidth() const {
+    return width;
+}
+
+int TiledMazeGenerator::getHeight() const {
+    return height;
+}
+
+int TiledMazeGenerator::getTileCountX() const {
+    return tilesX;
+}
+
+int TiledMazeGenerator::getTileCountY() const {
+    return tilesY;
+}
+
+const std::vector<std::vector<int>>& TiledMazeGenerator::getMaze() const {
+    return maze;
+}
@@ -0,0 +1,82 @@
+#include "wallTextures.h"
+
+uint32_t WallTextureAtlas::generateTexel(int slot, int u, int v) {
+    float grain = noise(u, v, slot);
+    switch (slot) {
+        case 0: {
+            // Red brick, running bond with grey mortar
+            int brickHeight = TEXTURE_SIZE / 4;
+            int brickWidth = TEXTURE_SIZE / 2;
+            int row = v / brickHeight;
+            int shifted = u + (row % 2) * (brickWidth / 2);
+            bool mortar = v % brickHeight == 0 || shifted % brickWidth == 0;
+            if (mortar) {
+                int shade = 140 + static_cast<int>(grain * 30);
+                return packColor(shade, shade, shade);
+            }
+            float tone = 0.8f + 0.4f * noise(shifted / brickWidth, row, 17) + 0.15f * grain;
+            return packColor(static_cast<int>(190 * tone), static_cast<int>(45 * tone), static_cast<int>(35 * tone));
+        }
+        case 1: {
+            // Yellow and black hazard stripes, marks the entrance and exit
+            bool stripe = ((u + v) / (TEXTURE_SIZE / 4)) % 2 == 0;
+            float tone = 0.9f + 0.2f * grain;
+            return stripe ? packColor(static_cast<int>(240 * tone), static_cast<int>(220 * tone), 20)
+                          : packColor(static_cast<int>(30 * tone), static_cast<int>(30 * tone), static_cast<int>(30 * tone));
+        }
+        case 2: {
+            // Grey stone blocks
+            int block = TEXTURE_SIZE / 2;
+            bool seam = u % block == 0 || v % block == 0;
+            float tone = seam ? 0.55f : 0.85f + 0.3f * noise(u / block, v / block, 31) + 0.2f * grain;
+            int shade = static_cast<int>(100 * tone);
+            return packColor(shade, shade, shade + 5);
+        }
+        case FLOOR_SLOT: {
+            // Dark blue floor tiles, four to a cell
+            int tile = TEXTURE_SIZE / 2;
+            bool grout = u % tile == 0 || v % tile == 0;
+            float tone = grout ? 0.5f : 0.8f + 0.25f * noise(u / tile, v / tile, 47) + 0.15f * grain;
+            return packColor(static_cast<int>(25 * tone), static_cast<int>(30 * tone), static_cast<int>(110 * tone));
+        }
+        default: {
+            // Plain ceiling panels
+            bool joint = u == 0 || v == 0;
+            float tone = joint ? 0.6f : 0.9f + 0.1f * grain;
+            return packColor(static_cast<int>(20 * tone), static_cast<int>(20 * tone), static_cast<int>(90 * tone));
+        }
+    }
+}
+
+void WallTextureAtlas::build() {
+    int offset = 0;
+    for (int level = 0; level < MIP_LEVELS; level++) {
+        levelOffsets[level] = offset;
+        int size = TEXTURE_SIZE >> level;
+        offset += size * size;
+    }
+
+    texels.assign(static_cast<size_t>(TEXELS_PER_TEXTURE) * TEXTURE_COUNT, 0);
+    for (int slot = 0; slot < TEXTURE_COUNT; slot++) {
+        uint32_t* top = writableTexture(slot, 0);
+        for (int u = 0; u < TEXTURE_SIZE; u++) {
+            for (int v = 0; v < TEXTURE_SIZE; v++) {
+                top[u * TEXTURE_SIZE + v] = generateTexel(slot, u, v);
+            }
+        }
+
+        for (int level = 1; level < MIP_LEVELS; level++) {
+            const uint32_t* above = writableTexture(slot, level - 1);
+            uint32_t* below = writableTexture(slot, level);
+            int size = TEXTURE_SIZE >> level;
+            int aboveSize = size * 2;
+            for (int u = 0; u < size; u++) {
+                for (int v = 0; v < size; v++) {
+                    const uint32_t* left = above + (2 * u) * aboveSize + 2 * v;
+                    const uint32_t* right = left + aboveSize;
+                    below[u * size + v] = average(left[0], left[1], right[0], right[1]);
+                }
+            }
+        }
+    }
+}